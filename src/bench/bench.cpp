@@ -0,0 +1,344 @@
+//
+// Created by:
+//    Cauim de S. Lima - cauimsouza@gmail.com
+//    Victor Hugo Vianna Silva - victor.vianna10@gmail.com
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "graph.h"
+
+// seed of the random boards and of the shuffle of the constraints of unique_sol
+#define bench_seed 2017
+// tries of the random walk growing a board before it is accepted shorter
+#define walk_tries 1000
+// boards with at most so many paths have their count checked against an enumeration
+#define max_enumerated 100000
+
+
+/**
+ * A board of the corpus with the endpoints of its paths
+ */
+struct Board
+{
+    std::string name;
+    std::vector< std::vector<int> > adj_list;
+    int source;
+    int target;
+};
+
+/**
+ * Time of every trial of a task on a board, and what the task returned
+ */
+struct Result
+{
+    std::string board;
+    int n_vertices;
+    std::string task;
+    std::vector<double> seconds;
+    std::string answer;
+};
+
+/**
+ * @brief Reads a board in the input format of RikudoSolver, endpoints included
+ */
+Board read_board(const std::string& name, const std::string& file_name)
+{
+    std::ifstream file(file_name);
+    if(!file)   throw "Unable to open board file";
+
+    Graph graph(file);
+    Board board;
+    board.name = name;
+    board.adj_list = graph.get_adj_list();
+    file >> board.source >> board.target;
+    return board;
+}
+
+/**
+ * @brief Squared grid of side n, with a path between two of its corners: the
+ * opposite ones when n is odd, the ones of the same row otherwise
+ */
+Board grid_board(int n)
+{
+    Board board;
+    board.name = "grid" + std::to_string(n);
+    board.adj_list.assign(n*n, std::vector<int>());
+
+    int di[] = {1,0,-1,0};
+    int dj[] = {0,1,0,-1};
+    for(int i = 0; i < n; i++)
+        for(int j = 0; j < n; j++)
+            for(int k = 0; k < 4; k++){
+                int ii = i + di[k];
+                int jj = j + dj[k];
+                if(ii >= 0 && ii < n && jj >= 0 && jj < n)
+                    board.adj_list[i*n+j].push_back(ii*n+jj);
+            }
+
+    board.source = 0;
+    board.target = n % 2 ? n*n - 1 : n - 1;
+    return board;
+}
+
+/**
+ * @brief Random blob of hexagons grown by a self avoiding walk, so that the walk
+ * is a hamiltonian path between its ends
+ *
+ * @param size number of hexagons
+ * @param seed seed of the walk
+ */
+Board hex_board(int size, unsigned seed)
+{
+    // axial coordinates of the six neighbors of a hexagon
+    int dx[] = {1,0,-1,0,1,-1};
+    int dy[] = {0,1,0,-1,-1,1};
+
+    std::mt19937 rng(seed);
+    std::vector< std::pair<int,int> > walk;
+    for(int t = 0; t < walk_tries && (int) walk.size() < size; t++){
+        std::vector< std::pair<int,int> > cells(1, std::make_pair(0, 0));
+        std::set< std::pair<int,int> > used(cells.begin(), cells.end());
+        while((int) cells.size() < size){
+            std::vector< std::pair<int,int> > free;
+            for(int k = 0; k < 6; k++){
+                std::pair<int,int> next(cells.back().first + dx[k], cells.back().second + dy[k]);
+                if(!used.count(next))   free.push_back(next);
+            }
+            if(free.empty())    break;
+            cells.push_back(free[rng() % free.size()]);
+            used.insert(cells.back());
+        }
+        if(cells.size() > walk.size())  walk.swap(cells);
+    }
+
+    Board board;
+    board.name = "hex" + std::to_string(size) + "-" + std::to_string(seed);
+    board.adj_list.assign(walk.size(), std::vector<int>());
+    for(int u = 0; u < (int) walk.size(); u++)
+        for(int v = 0; v < (int) walk.size(); v++)
+            for(int k = 0; k < 6; k++)
+                if(walk[u].first + dx[k] == walk[v].first && walk[u].second + dy[k] == walk[v].second)
+                    board.adj_list[u].push_back(v);
+    board.source = 0;
+    board.target = walk.size() - 1;
+    return board;
+}
+
+/**
+ * @brief Answer of a path search: the number of paths found, or "invalid" if the path
+ * found is not a hamiltonian path of the board between its endpoints
+ */
+std::string path_answer(const Board& board, const std::vector< std::vector<int> >& paths)
+{
+    int n = board.adj_list.size();
+    for(auto& path : paths){
+        if((int) path.size() != n || path.front() != board.source || path.back() != board.target)
+            return "invalid";
+        std::vector<bool> seen(n, false);
+        for(int i = 0; i < n; i++){
+            if(path[i] < 0 || path[i] >= n || seen[path[i]])
+                return "invalid";
+            seen[path[i]] = true;
+            if(i == 0)  continue;
+            const auto& prev = board.adj_list[path[i - 1]];
+            if(std::find(prev.begin(), prev.end(), path[i]) == prev.end())
+                return "invalid";
+        }
+    }
+    return std::to_string(paths.size());
+}
+
+/**
+ * @brief Times a task on a fresh graph for every trial
+ *
+ * @param task runs the task on the graph and returns its answer
+ */
+Result run(const Board& board, const std::string& name, int trials,
+           const std::function<std::string(Graph&)>& task)
+{
+    Result result;
+    result.board = board.name;
+    result.n_vertices = board.adj_list.size();
+    result.task = name;
+    for(int trial = 0; trial < trials; trial++){
+        Graph graph(board.adj_list);
+        graph.set_shuffle_seed(bench_seed);
+        auto start = std::chrono::steady_clock::now();
+        result.answer = task(graph);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        result.seconds.push_back(elapsed.count());
+    }
+    return result;
+}
+
+std::vector<Result> bench(const Board& board, int trials)
+{
+    int s = board.source;
+    int t = board.target;
+    std::vector<Result> results;
+
+    results.push_back(run(board, "path", trials, [&board, s, t](Graph& graph){
+        return path_answer(board, graph.ham_path(s, t));
+    }));
+    results.push_back(run(board, "path-bt", trials, [&board, s, t](Graph& graph){
+        return path_answer(board, graph.ham_path(s, t, false));
+    }));
+    results.push_back(run(board, "count", trials, [s, t](Graph& graph){
+        return std::to_string(graph.count_paths(s, t));
+    }));
+    if(std::stoll(results.back().answer) <= max_enumerated){
+        results.push_back(run(board, "count-bt", trials, [s, t](Graph& graph){
+            return std::to_string(graph.ham_path(s, t, false, true).size());
+        }));
+    }
+    results.push_back(run(board, "cycle", trials, [](Graph& graph){
+        return std::to_string(graph.ham_cycle().size());
+    }));
+    results.push_back(run(board, "unique", trials, [s, t](Graph& graph){
+        // number of map and diamond conditions of the puzzle
+        std::ostringstream out;
+        graph.unique_sol(s, t, out);
+        std::istringstream in(out.str());
+        int x, sections = 0, n_cons = 0;
+        while(in >> x){
+            if(x == -1)         sections++;
+            else if(sections)   n_cons++;
+        }
+        return std::to_string(n_cons / 2);
+    }));
+    return results;
+}
+
+/**
+ * @brief Cross-checks the answers of the engines on a board: the paths returned must
+ * be valid, SAT and backtracking must agree on whether there is a path, and so must
+ * the count, which must also match the enumeration of the paths when it was run
+ *
+ * @param results results of bench on the board
+ * @return one line per mismatch
+ */
+std::vector<std::string> check(const std::vector<Result>& results)
+{
+    std::map<std::string, std::string> answer;
+    for(auto& r : results)
+        answer[r.task] = r.answer;
+
+    std::vector<std::string> mismatches;
+    auto expect = [&](bool agree, const std::string& what){
+        if(!agree)  mismatches.push_back(results[0].board + ": " + what);
+    };
+    expect(answer["path"] != "invalid", "invalid path from SAT");
+    expect(answer["path-bt"] != "invalid", "invalid path from backtracking");
+    expect(answer["path"] == answer["path-bt"],
+           "SAT finds " + answer["path"] + " paths, backtracking " + answer["path-bt"]);
+    expect(answer["path"] == (answer["count"] == "0" ? "0" : "1"),
+           "SAT finds " + answer["path"] + " paths, the count is " + answer["count"]);
+    if(answer.count("count-bt"))
+        expect(answer["count"] == answer["count-bt"],
+               "the count is " + answer["count"] + ", " + answer["count-bt"] + " paths are enumerated");
+    return mismatches;
+}
+
+double mean(const std::vector<double>& v)
+{
+    double sum = 0;
+    for(double x : v)
+        sum += x;
+    return v.empty() ? 0 : sum / v.size();
+}
+
+void write_csv(const std::vector<Result>& results, std::ostream& out)
+{
+    out << "board,vertices,task,answer,trials,mean,min,max\n";
+    for(auto& r : results)
+        out << r.board << "," << r.n_vertices << "," << r.task << "," << r.answer << ","
+            << r.seconds.size() << "," << mean(r.seconds) << ","
+            << *std::min_element(r.seconds.begin(), r.seconds.end()) << ","
+            << *std::max_element(r.seconds.begin(), r.seconds.end()) << "\n";
+}
+
+void write_json(const std::vector<Result>& results, std::ostream& out)
+{
+    out << "[\n";
+    for(int i = 0; i < (int) results.size(); i++){
+        const Result& r = results[i];
+        out << "  {\"board\":\"" << r.board << "\",\"vertices\":" << r.n_vertices
+            << ",\"task\":\"" << r.task << "\",\"answer\":\"" << r.answer << "\",\"seconds\":[";
+        for(int k = 0; k < (int) r.seconds.size(); k++)
+            out << (k ? "," : "") << r.seconds[k];
+        out << "]}" << (i + 1 < (int) results.size() ? "," : "") << "\n";
+    }
+    out << "]\n";
+}
+
+/**
+ * @brief Runs path finding, counting, cycle finding and unique_sol over a fixed corpus:
+ * the boards of the example images, a board of hexagon blobs joined by narrow necks,
+ * squared grids and random hexagon blobs. The answers of the engines are cross-checked
+ * (see check) and the bench exits with 1 on any mismatch; the answers only depend on
+ * the code, so two reports can also be diffed to find regressions.
+ * Usage: RikudoBench [--trials=N] [--csv=FILE] [--json=FILE] [corpus directory]
+ */
+int main(int argc, char const *argv[])
+{
+    int trials = 3;
+    std::string csv_file, json_file;
+    std::string corpus = "src/bench/corpus";
+    for(int i = 1; i < argc; i++){
+        std::string arg(argv[i]);
+        if(arg.compare(0, 9, "--trials=") == 0)     trials = std::max(1, atoi(arg.substr(9).c_str()));
+        else if(arg.compare(0, 6, "--csv=") == 0)   csv_file = arg.substr(6);
+        else if(arg.compare(0, 7, "--json=") == 0)  json_file = arg.substr(7);
+        else                                        corpus = arg;
+    }
+
+    std::vector<Board> boards;
+    try{
+        for(const char* name : {"square", "christmasTree", "bowtie", "necked"})
+            boards.push_back(read_board(name, corpus + "/" + name + ".txt"));
+    }
+    catch(const char* message){
+        std::cerr << message << " in " << corpus << "\n";
+        return 1;
+    }
+    for(int n = 4; n <= 7; n++)
+        boards.push_back(grid_board(n));
+    for(int size : {20, 30, 40})
+        boards.push_back(hex_board(size, bench_seed + size));
+
+    std::vector<Result> results;
+    std::vector<std::string> mismatches;
+    for(auto& board : boards){
+        std::vector<Result> board_results = bench(board, trials);
+        for(auto& r : board_results)
+            std::cerr << r.board << " " << r.task << " " << r.answer << " " << mean(r.seconds) << "s\n";
+        results.insert(results.end(), board_results.begin(), board_results.end());
+        for(auto& mismatch : check(board_results))
+            mismatches.push_back(mismatch);
+    }
+
+    write_csv(results, std::cout);
+    if(!csv_file.empty()){
+        std::ofstream out(csv_file);
+        write_csv(results, out);
+    }
+    if(!json_file.empty()){
+        std::ofstream out(json_file);
+        write_json(results, out);
+    }
+
+    for(auto& mismatch : mismatches)
+        std::cerr << "mismatch " << mismatch << "\n";
+    return mismatches.empty() ? 0 : 1;
+}
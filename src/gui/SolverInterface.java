@@ -25,6 +25,8 @@ public class SolverInterface {
 	private final Color boundaryColor = Color.RED;
 	private final String graphFile = "graph.txt";
 	private final String solutionFile = "solution.txt"; 
+	private final String cacheFile = "cache.bin"; // results of the boards already solved
+	private final String pairsFile = "pairs.txt"; // board given to the computation of the pairs
 	private final String imageFile = "input.png";
 	private HashMap<Integer, Axial> intToAxial;
 	private HashMap<Axial, Integer> axialToInt;
@@ -33,6 +35,8 @@ public class SolverInterface {
 	private ArrayList<Diamond> diamonds;
 	private TreeMap<Integer, Integer> partialMap;
 	private int source, destination;
+	private volatile boolean[][] feasiblePairs; // pairs (source, destination) joined by a path, null until known
+	private Process pairsProcess;
 	
 	
 	private final static Axial[] neighbors = new Axial[]{
@@ -68,6 +72,7 @@ public class SolverInterface {
 			printLabel(img, i, "v"+Integer.toString(i+1));	///adding number labels to initial image
 		
 		new Image2dViewer(img);  /// printing grid with no solution		
+		startPairs();
 		Scanner sc = new Scanner(System.in);
 		do {
 			System.out.printf("Source (1 to %d): ", adjList.size());
@@ -79,10 +84,16 @@ public class SolverInterface {
 			source--;
 			destination--;
 			
+			if(!isFeasible(source, destination)) {
+				System.out.println("This yields no solution. Try again.");
+				path = new LinkedList<>();
+				continue;
+			}
+			
 			writeGraph();			
 			try {
 				//String path = SolverInterface.class.getProtectionDomain().getCodeSource().getLocation().toURI().getPath();
-				ProcessBuilder pb = new ProcessBuilder("./RikudoSolver", graphFile,  solutionFile);
+				ProcessBuilder pb = new ProcessBuilder("./RikudoSolver", "--cache=" + cacheFile, graphFile,  solutionFile);
 			    Process p = pb.start();     // Start the process.
 			    p.waitFor();                // Wait for the process to finish.
 			    
@@ -94,6 +105,7 @@ public class SolverInterface {
 			if(path.size()==0)
 				System.out.println("This yields no solution. Try again.");
 		}while(path.size()==0);
+		stopPairs();
 	
 		printConstraints(img_constraints);
 		printPath(img_solved);
@@ -104,6 +116,50 @@ public class SolverInterface {
 
 	}
 	
+	// asks the solver once which pairs of endpoints admit a path, in the background:
+	// every pair is solved until the answer arrives
+	private void startPairs() {
+		feasiblePairs = null;
+		writeGraph(pairsFile, 0, 0);
+		Thread reader = new Thread(() -> {
+			try {
+				ProcessBuilder pb = new ProcessBuilder("./RikudoSolver", "--cache=" + cacheFile, "--pairs", pairsFile);
+				Process p;
+				synchronized(this) {
+					p = pb.start();
+					pairsProcess = p;
+				}
+				Scanner sc = new Scanner(p.getInputStream());
+				int n = sc.nextInt();
+				boolean[][] pairs = new boolean[n][n];
+				for(int u = 0; u < n; u++) {
+					String row = sc.next();
+					for(int v = 0; v < n; v++)
+						pairs[u][v] = row.charAt(v) == '1';
+				}
+				p.waitFor();
+				feasiblePairs = pairs;
+			} catch (Exception e) {
+				// every pair keeps being solved
+			}
+		});
+		reader.setDaemon(true);
+		reader.start();
+	}
+	
+	// stops the computation of the pairs if it is still running
+	private synchronized void stopPairs() {
+		if(pairsProcess != null && pairsProcess.isAlive())
+			pairsProcess.destroy();
+	}
+	
+	private boolean isFeasible(int u, int v) {
+		if(u < 0 || v < 0 || u >= adjList.size() || v >= adjList.size())
+			return false;
+		boolean[][] pairs = feasiblePairs;
+		return pairs == null || pairs[u][v];
+	}
+	
 	private void addHexagons(BufferedImage file, Image2d img){		
 		for(int i=0; i*img.getHexSize()<file.getHeight();i++)
 		{
@@ -151,6 +207,10 @@ public class SolverInterface {
 	}
 	
 	private void writeGraph() {
+		writeGraph(graphFile, source, destination);
+	}
+	
+	private void writeGraph(String fileName, int source, int destination) {
 		StringBuilder graphText = new StringBuilder();
 		
 		graphText.append(adjList.size() + "\n");
@@ -162,10 +222,10 @@ public class SolverInterface {
 		graphText.append("-1\n");
 		graphText.append(String.format("%d %d\n", source, destination));
 		try {
-			Files.write(Paths.get(graphFile), graphText.toString().getBytes());
+			Files.write(Paths.get(fileName), graphText.toString().getBytes());
 		}
 		catch(Exception e) {
-			System.out.println("Error writing graph to file " + graphFile);
+			System.out.println("Error writing graph to file " + fileName);
 		}
 	}
 	
@@ -0,0 +1,154 @@
+//
+// Created by:
+//    Cauim de S. Lima - cauimsouza@gmail.com
+//    Victor Hugo Vianna Silva - victor.vianna10@gmail.com
+//
+
+#include "amo_encoding.h"
+#include <algorithm>
+#include <cmath>
+
+
+// below this size every encoding falls back to the pairwise one
+#define small_amo 6
+#define commander_group 3
+
+bool parse_amo_encoding(const std::string& name, AmoEncoding& encoding)
+{
+    if(name == "pairwise")          encoding = AmoEncoding::PAIRWISE;
+    else if(name == "sequential")   encoding = AmoEncoding::SEQUENTIAL;
+    else if(name == "commander")    encoding = AmoEncoding::COMMANDER;
+    else if(name == "product")      encoding = AmoEncoding::PRODUCT;
+    else if(name == "bimander")     encoding = AmoEncoding::BIMANDER;
+    else                            return false;
+    return true;
+}
+
+static void binary_clause(int a, int b, ClauseSink& sink)
+{
+    sink.add(a);
+    sink.add(b);
+    sink.add(0);
+}
+
+static void amo_pairwise(const std::vector<int>& lits, ClauseSink& sink)
+{
+    for(int j = 0; j < (int) lits.size(); j++)
+        for(int k = j + 1; k < (int) lits.size(); k++)
+            binary_clause(-lits[j], -lits[k], sink);
+}
+
+// s_i is true if one of the first i+1 literals is true
+static void amo_sequential(const std::vector<int>& lits, int& n_vars,
+                           ClauseSink& sink)
+{
+    int n = lits.size();
+    int prev = 0;
+    for(int i = 0; i < n; i++){
+        if(i > 0)
+            binary_clause(-lits[i], -prev, sink);
+        if(i == n - 1)
+            break;
+
+        int s = ++n_vars;
+        binary_clause(-lits[i], s, sink);
+        if(i > 0)
+            binary_clause(-prev, s, sink);
+        prev = s;
+    }
+}
+
+// each group of literals has a commander which is true if one of them is
+static void amo_commander(const std::vector<int>& lits, int& n_vars,
+                          ClauseSink& sink)
+{
+    if(lits.size() <= small_amo){
+        amo_pairwise(lits, sink);
+        return;
+    }
+
+    std::vector<int> commanders;
+    for(int start = 0; start < (int) lits.size(); start += commander_group){
+        std::vector<int> group(lits.begin() + start,
+                               lits.begin() + std::min((int) lits.size(), start + commander_group));
+        amo_pairwise(group, sink);
+
+        int c = ++n_vars;
+        for(int x : group)
+            binary_clause(-x, c, sink);
+        commanders.push_back(c);
+    }
+
+    amo_commander(commanders, n_vars, sink);
+}
+
+// literals are laid out in a grid, a true literal forces its row and its column
+static void amo_product(const std::vector<int>& lits, int& n_vars,
+                        ClauseSink& sink)
+{
+    int n = lits.size();
+    if(n <= small_amo){
+        amo_pairwise(lits, sink);
+        return;
+    }
+
+    int p = (int) std::ceil(std::sqrt((double) n));
+    int q = (n + p - 1) / p;
+
+    std::vector<int> rows, cols;
+    for(int i = 0; i < q; i++)  rows.push_back(++n_vars);
+    for(int j = 0; j < p; j++)  cols.push_back(++n_vars);
+
+    for(int k = 0; k < n; k++){
+        binary_clause(-lits[k], rows[k / p], sink);
+        binary_clause(-lits[k], cols[k % p], sink);
+    }
+
+    amo_product(rows, n_vars, sink);
+    amo_product(cols, n_vars, sink);
+}
+
+// literals are paired, and the index of the pair holding the true literal is
+// written in binary on the commander variables
+static void amo_bimander(const std::vector<int>& lits, int& n_vars,
+                         ClauseSink& sink)
+{
+    int n = lits.size();
+    if(n <= small_amo){
+        amo_pairwise(lits, sink);
+        return;
+    }
+
+    int n_groups = (n + 1) / 2;
+    int n_bits = 0;
+    while((1 << n_bits) < n_groups)
+        n_bits++;
+
+    std::vector<int> bits;
+    for(int b = 0; b < n_bits; b++)
+        bits.push_back(++n_vars);
+
+    for(int g = 0; g < n_groups; g++){
+        int first = 2 * g;
+        if(first + 1 < n)
+            binary_clause(-lits[first], -lits[first + 1], sink);
+
+        for(int k = first; k < std::min(n, first + 2); k++)
+            for(int b = 0; b < n_bits; b++)
+                binary_clause(-lits[k], (g >> b) & 1 ? bits[b] : -bits[b], sink);
+    }
+}
+
+void at_most_one(AmoEncoding encoding,
+                 const std::vector<int>& lits,
+                 int& n_vars,
+                 ClauseSink& sink)
+{
+    switch(encoding){
+        case AmoEncoding::PAIRWISE:     amo_pairwise(lits, sink); break;
+        case AmoEncoding::SEQUENTIAL:   amo_sequential(lits, n_vars, sink); break;
+        case AmoEncoding::COMMANDER:    amo_commander(lits, n_vars, sink); break;
+        case AmoEncoding::PRODUCT:      amo_product(lits, n_vars, sink); break;
+        case AmoEncoding::BIMANDER:     amo_bimander(lits, n_vars, sink); break;
+    }
+}
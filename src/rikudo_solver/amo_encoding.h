@@ -0,0 +1,49 @@
+//
+// Created by:
+//    Cauim de S. Lima - cauimsouza@gmail.com
+//    Victor Hugo Vianna Silva - victor.vianna10@gmail.com
+//
+
+#ifndef RIKUDOSOLVER_AMO_ENCODING_H
+#define RIKUDOSOLVER_AMO_ENCODING_H
+
+#include <string>
+#include <vector>
+#include "sat_solver.h"
+
+/**
+ * CNF encodings of the constraint "at most one of these literals is true"
+ */
+enum class AmoEncoding
+{
+    PAIRWISE,   // n(n-1)/2 binary clauses, no auxiliary variable
+    SEQUENTIAL, // sequential counter (Sinz), 3n clauses and n auxiliary variables
+    COMMANDER,  // commander variables over groups of 3 (Klieber and Kwon)
+    PRODUCT,    // two-dimensional product encoding (Chen)
+    BIMANDER    // pairs of literals sharing log2(n) binary commander variables (Nguyen and Mai)
+};
+
+/**
+ * @brief Parses the name of an encoding
+ *
+ * @param name one of "pairwise", "sequential", "commander", "product" or "bimander"
+ * @param encoding where the parsed encoding is stored
+ * @return false if the name is unknown
+ */
+bool parse_amo_encoding(const std::string& name, AmoEncoding& encoding);
+
+/**
+ * @brief Adds clauses forcing at most one of the given literals to be true
+ *
+ * @param encoding encoding to be used
+ * @param lits literals of the constraint
+ * @param n_vars number of variables already in use, auxiliary variables are allocated
+ * after it and the counter is updated
+ * @param sink where the generated clauses are written
+ */
+void at_most_one(AmoEncoding encoding,
+                 const std::vector<int>& lits,
+                 int& n_vars,
+                 ClauseSink& sink);
+
+#endif //RIKUDOSOLVER_AMO_ENCODING_H
@@ -0,0 +1,207 @@
+//
+// Created by:
+//    Cauim de S. Lima - cauimsouza@gmail.com
+//    Victor Hugo Vianna Silva - victor.vianna10@gmail.com
+//
+
+#include "board_file.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define board_magic "RIKUDOB"
+
+
+BoardFile::BoardFile(const std::string& path) : data(nullptr), size(0)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+        throw "Unable to open board file";
+    struct stat st;
+    if(fstat(fd, &st) < 0 || st.st_size < (off_t) sizeof(BoardHeader)){
+        close(fd);
+        throw "Invalid board file";
+    }
+    size = st.st_size;
+    data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(data == MAP_FAILED){
+        data = nullptr;
+        throw "Unable to map board file";
+    }
+
+    // everything read below must be inside the file, the counts are bounded by its
+    // size before the sizes of the arrays are computed
+    header = static_cast<const BoardHeader*>(data);
+    const char* begin = static_cast<const char*>(data);
+    size_t n = header->n_vertices;
+    size_t offsets_at = sizeof(BoardHeader);
+    size_t neighbors_at = 0, map_at = 0, diamonds_at = 0;
+
+    const char* error = nullptr;
+    if(std::memcmp(header->magic, board_magic, sizeof(board_magic)) != 0)
+        error = "Invalid board file";
+    else if(header->version != BOARD_FILE_VERSION)
+        error = "Unsupported board file version";
+    else if(n == 0 || n > size / sizeof(uint64_t) || header->n_arcs > size / sizeof(int32_t) ||
+            header->n_map > size || header->n_diamonds > size)
+        error = "Truncated board file";
+    else{
+        neighbors_at = offsets_at + (n + 1) * sizeof(uint64_t);
+        map_at = neighbors_at + header->n_arcs * sizeof(int32_t);
+        diamonds_at = map_at + 2 * (size_t) header->n_map * sizeof(int32_t);
+        if(diamonds_at + 2 * (size_t) header->n_diamonds * sizeof(int32_t) != size)
+            error = "Truncated board file";
+    }
+    if(error){
+        munmap(data, size);
+        data = nullptr;
+        throw error;
+    }
+
+    offsets = reinterpret_cast<const uint64_t*>(begin + offsets_at);
+    neighbors = reinterpret_cast<const int32_t*>(begin + neighbors_at);
+    map_pairs = reinterpret_cast<const int32_t*>(begin + map_at);
+    diamond_pairs = reinterpret_cast<const int32_t*>(begin + diamonds_at);
+
+    int n_vertices = n;
+    if(offsets[0] != 0 || offsets[n] != header->n_arcs)
+        error = "Invalid board file";
+    for(size_t v = 0; v < n && !error; v++)
+        if(offsets[v] > offsets[v+1])   error = "Invalid board file";
+    for(uint64_t a = 0; a < header->n_arcs && !error; a++)
+        if(neighbors[a] < 0 || neighbors[a] >= n_vertices)  error = "Invalid vertex index";
+    if(header->source < 0 || header->source >= n_vertices ||
+       header->target < 0 || header->target >= n_vertices)
+        error = "Invalid vertex index";
+    for(uint32_t k = 0; k < header->n_map && !error; k++)
+        if(map_pairs[2*k] < 0 || map_pairs[2*k] >= n_vertices ||
+           map_pairs[2*k+1] < 0 || map_pairs[2*k+1] >= n_vertices)
+            error = "Invalid vertex index";
+    for(uint32_t k = 0; k < 2 * header->n_diamonds && !error; k++)
+        if(diamond_pairs[k] < 0 || diamond_pairs[k] >= n_vertices)
+            error = "Invalid vertex index";
+    if(error){
+        munmap(data, size);
+        data = nullptr;
+        throw error;
+    }
+}
+
+BoardFile::~BoardFile()
+{
+    if(data)    munmap(data, size);
+}
+
+std::vector< std::vector<int> > BoardFile::adj_list() const
+{
+    std::vector< std::vector<int> > adj(n_vertices());
+    for(int v = 0; v < n_vertices(); v++)
+        adj[v].assign(neighbors_of(v), neighbors_of(v) + degree(v));
+    return adj;
+}
+
+std::vector< std::pair<int,int> > BoardFile::map() const
+{
+    std::vector< std::pair<int,int> > pairs;
+    for(uint32_t k = 0; k < header->n_map; k++)
+        pairs.push_back(std::make_pair(map_pairs[2*k], map_pairs[2*k+1]));
+    return pairs;
+}
+
+std::vector< std::pair<int,int> > BoardFile::diamonds() const
+{
+    std::vector< std::pair<int,int> > pairs;
+    for(uint32_t k = 0; k < header->n_diamonds; k++)
+        pairs.push_back(std::make_pair(diamond_pairs[2*k], diamond_pairs[2*k+1]));
+    return pairs;
+}
+
+bool BoardFile::is_board_file(const std::string& path)
+{
+    char magic[sizeof(board_magic)];
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if(file == nullptr) return false;
+    bool is_board = std::fread(magic, 1, sizeof(magic), file) == sizeof(magic) &&
+                    std::memcmp(magic, board_magic, sizeof(magic)) == 0;
+    std::fclose(file);
+    return is_board;
+}
+
+void write_board(const std::string& path,
+                 const std::vector< std::vector<int> >& adj_list,
+                 int source, int target,
+                 const std::vector< std::pair<int,int> >& map,
+                 const std::vector< std::pair<int,int> >& diamonds)
+{
+    int n = adj_list.size();
+    if(n == 0)
+        throw "Number of vertices should be a positive integer.";
+    if(source < 0 || source >= n || target < 0 || target >= n)
+        throw "Invalid vertex index";
+
+    std::vector< std::vector<int> > sorted(adj_list);
+    for(auto& neighbors : sorted){
+        std::sort(neighbors.begin(), neighbors.end());
+        if(std::adjacent_find(neighbors.begin(), neighbors.end()) != neighbors.end())
+            throw "Duplicate edge";
+    }
+    for(int u = 0; u < n; u++)
+        for(int v : sorted[u]){
+            if(v < 0 || v >= n)
+                throw "Invalid vertex index";
+            if(v == u)
+                throw "Vertex adjacent to itself";
+            if(!std::binary_search(sorted[v].begin(), sorted[v].end(), u))
+                throw "Edge without its reverse";
+        }
+    for(auto ith_vertex : map)
+        if(ith_vertex.first < 0 || ith_vertex.first >= n || ith_vertex.second < 0 || ith_vertex.second >= n)
+            throw "Invalid vertex index";
+    for(auto u_v : diamonds)
+        if(u_v.first < 0 || u_v.first >= n || u_v.second < 0 || u_v.second >= n)
+            throw "Invalid vertex index";
+
+    BoardHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, board_magic, sizeof(board_magic));
+    header.version = BOARD_FILE_VERSION;
+    header.n_vertices = n;
+    header.source = source;
+    header.target = target;
+    header.n_map = map.size();
+    header.n_diamonds = diamonds.size();
+
+    std::vector<uint64_t> offsets(1, 0);
+    std::vector<int32_t> neighbors;
+    for(auto& list : adj_list){
+        neighbors.insert(neighbors.end(), list.begin(), list.end());
+        offsets.push_back(neighbors.size());
+    }
+    header.n_arcs = neighbors.size();
+
+    std::vector<int32_t> pairs;
+    for(auto ith_vertex : map){
+        pairs.push_back(ith_vertex.first);
+        pairs.push_back(ith_vertex.second);
+    }
+    for(auto u_v : diamonds){
+        pairs.push_back(u_v.first);
+        pairs.push_back(u_v.second);
+    }
+
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if(file == nullptr)
+        throw "Unable to open output file";
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = ok && std::fwrite(offsets.data(), sizeof(uint64_t), offsets.size(), file) == offsets.size();
+    ok = ok && std::fwrite(neighbors.data(), sizeof(int32_t), neighbors.size(), file) == neighbors.size();
+    ok = ok && std::fwrite(pairs.data(), sizeof(int32_t), pairs.size(), file) == pairs.size();
+    ok = std::fclose(file) == 0 && ok;
+    if(!ok)
+        throw "Unable to write board file";
+}
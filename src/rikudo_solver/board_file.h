@@ -0,0 +1,125 @@
+//
+// Created by:
+//    Cauim de S. Lima - cauimsouza@gmail.com
+//    Victor Hugo Vianna Silva - victor.vianna10@gmail.com
+//
+
+#ifndef RIKUDOSOLVER_BOARD_FILE_H
+#define RIKUDOSOLVER_BOARD_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Version of the binary board format written by write_board
+ */
+const uint32_t BOARD_FILE_VERSION = 1;
+
+/**
+ * @brief Header of a binary board file
+ * @details The header is followed by
+ * - n_vertices + 1 offsets (uint64_t), the neighbors of vertex v being the entries
+ * offsets[v] to offsets[v+1] - 1 of the next array,
+ * - n_arcs neighbors (int32_t),
+ * - n_map pairs (i, v) of int32_t, "vertex v must be visited at instant i",
+ * - n_diamonds pairs (u, v) of int32_t, "u and v must be visited consecutively".
+ * Every array starts aligned for its type. Integers are stored in the byte order
+ * of the machine that wrote the file.
+ */
+struct BoardHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t n_vertices;
+    uint64_t n_arcs;
+    int32_t source;
+    int32_t target;
+    uint32_t n_map;
+    uint32_t n_diamonds;
+};
+
+/**
+ * @brief Read-only view of a binary board file mapped in memory
+ * @details The adjacency is used in place, in compressed sparse row form, without
+ * being parsed or copied. The sizes and the vertex indices are checked when the file
+ * is opened; the symmetry of the edges was checked when the file was written.
+ */
+class BoardFile
+{
+private:
+    void* data;
+    size_t size;
+
+    const BoardHeader* header;
+    const uint64_t* offsets;
+    const int32_t* neighbors;
+    const int32_t* map_pairs;
+    const int32_t* diamond_pairs;
+
+public:
+    /**
+     * @param path binary board file, see write_board
+     */
+    explicit BoardFile(const std::string& path);
+    ~BoardFile();
+
+    BoardFile(const BoardFile&) = delete;
+    BoardFile& operator=(const BoardFile&) = delete;
+
+    int n_vertices() const { return header->n_vertices; }
+    int source() const { return header->source; }
+    int target() const { return header->target; }
+
+    /**
+     * @return number of neighbors of vertex v
+     */
+    int degree(int v) const { return offsets[v+1] - offsets[v]; }
+
+    /**
+     * @return pointer to the degree(v) neighbors of vertex v, inside the mapped file
+     */
+    const int32_t* neighbors_of(int v) const { return neighbors + offsets[v]; }
+
+    /**
+     * @return adjacence list of the board, as taken by Graph
+     */
+    std::vector< std::vector<int> > adj_list() const;
+
+    /**
+     * @return pairs (i, v) such that vertex v must be visited at instant i
+     */
+    std::vector< std::pair<int,int> > map() const;
+
+    /**
+     * @return pairs (u, v) of vertices that must be visited consecutively
+     */
+    std::vector< std::pair<int,int> > diamonds() const;
+
+    /**
+     * @brief Checks whether a file starts with the magic of the binary board format
+     */
+    static bool is_board_file(const std::string& path);
+};
+
+/**
+ * @brief Writes a board in the binary format after checking it
+ * @details The edges must be undirected, every edge (u, v) having its reverse (v, u),
+ * and a vertex may not be its own neighbor or appear twice among the neighbors of another.
+ *
+ * @param path file where the board is written
+ * @param adj_list adjacence list of the board
+ * @param source origin of the paths
+ * @param target destination of the paths
+ * @param map list of pairs (i, v) representing "vertex v must be visited at instant i"
+ * @param diamonds list of pairs (u, v) representing "u and v must be visited consecutively"
+ */
+void write_board(const std::string& path,
+                 const std::vector< std::vector<int> >& adj_list,
+                 int source, int target,
+                 const std::vector< std::pair<int,int> >& map = {},
+                 const std::vector< std::pair<int,int> >& diamonds = {});
+
+#endif //RIKUDOSOLVER_BOARD_FILE_H
@@ -0,0 +1,624 @@
+//
+// Created by:
+//    Cauim de S. Lima - cauimsouza@gmail.com
+//    Victor Hugo Vianna Silva - victor.vianna10@gmail.com
+//
+
+#include "cdcl_solver.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+
+#define var_decay 0.95
+#define clause_decay 0.999
+#define restart_base 100
+#define learnts_growth 1.05
+
+const CdclSolver::CRef CdclSolver::CREF_UNDEF;
+const int CdclSolver::CLAUSE_HEADER;
+
+// restart sequence 1 1 2 1 1 2 4 1 1 2 ... scaled by powers of y
+static double luby(double y, int x)
+{
+    int size, seq;
+    for(size = 1, seq = 0; size < x + 1; seq++, size = 2 * size + 1);
+
+    while(size - 1 != x){
+        size = (size - 1) >> 1;
+        seq--;
+        x = x % size;
+    }
+
+    return std::pow(y, seq);
+}
+
+CdclSolver::CdclSolver(unsigned seed)
+    : wasted(0), qhead(0), var_inc(1), cla_inc(1), max_learnts(0), ok(true), stamp(0),
+      seed(seed), rng(seed)
+{
+}
+
+CdclSolver::Lit CdclSolver::to_lit(int dimacs)
+{
+    int v = std::abs(dimacs) - 1;
+    return 2 * v + (dimacs < 0 ? 1 : 0);
+}
+
+void CdclSolver::ensure_var(int v)
+{
+    while(n_vars() <= v){
+        int x = n_vars();
+        lit_value.push_back(0);
+        lit_value.push_back(0);
+        level.push_back(0);
+        reason.push_back(CREF_UNDEF);
+        activity.push_back(seed ? (rng() % 1000) * 1e-6 : 0);
+        polarity.push_back(seed ? rng() % 2 : 1);
+        seen.push_back(0);
+        watches.push_back(std::vector<Watcher>());
+        watches.push_back(std::vector<Watcher>());
+        heap_index.push_back(-1);
+        level_stamp.push_back(0);
+        heap_insert(x);
+    }
+    if(level_stamp.size() < level.size() + 1)
+        level_stamp.push_back(0);
+}
+
+float CdclSolver::clause_activity(CRef c) const
+{
+    float act;
+    std::memcpy(&act, &arena[c + 3], sizeof(float));
+    return act;
+}
+
+void CdclSolver::set_clause_activity(CRef c, float act)
+{
+    std::memcpy(&arena[c + 3], &act, sizeof(float));
+}
+
+bool CdclSolver::locked(CRef c)
+{
+    Lit first = clause_lits(c)[0];
+    return reason[var(first)] == c && lit_value[first] == 1;
+}
+
+CdclSolver::CRef CdclSolver::alloc_clause(const std::vector<Lit>& lits, bool learnt, int lbd)
+{
+    CRef c = (CRef) arena.size();
+    arena.push_back((int) lits.size());
+    arena.push_back(learnt ? FLAG_LEARNT : 0);
+    arena.push_back(lbd);
+    arena.push_back(0);
+    arena.insert(arena.end(), lits.begin(), lits.end());
+    set_clause_activity(c, 0);
+    return c;
+}
+
+void CdclSolver::attach_clause(CRef c)
+{
+    Lit* lits = clause_lits(c);
+    bool binary = clause_size(c) == 2;
+    Watcher w0 = {c, lits[1], binary};
+    Watcher w1 = {c, lits[0], binary};
+    watches[lits[0] ^ 1].push_back(w0);
+    watches[lits[1] ^ 1].push_back(w1);
+}
+
+// adds a clause to the formula, must be called at decision level 0
+void CdclSolver::add_internal(std::vector<Lit>& lits)
+{
+    if(!ok) return;
+
+    std::sort(lits.begin(), lits.end());
+    int j = 0;
+    for(int i = 0; i < (int) lits.size(); i++){
+        Lit l = lits[i];
+        if(lit_value[l] == 1)   return; // satisfied at level 0
+        if(j > 0 && lits[j-1] == (l ^ 1))   return; // tautology
+        if(lit_value[l] == -1)  continue;
+        if(j > 0 && lits[j-1] == l) continue;
+        lits[j++] = l;
+    }
+    lits.resize(j);
+
+    if(lits.empty()){
+        ok = false;
+    }
+    else if(lits.size() == 1){
+        enqueue(lits[0], CREF_UNDEF);
+        ok = propagate() == CREF_UNDEF;
+    }
+    else{
+        CRef c = alloc_clause(lits, false, 0);
+        clauses.push_back(c);
+        attach_clause(c);
+    }
+}
+
+void CdclSolver::add(int lit)
+{
+    if(lit != 0){
+        Lit l = to_lit(lit);
+        ensure_var(var(l));
+        clause_buffer.push_back(l);
+        return;
+    }
+
+    add_internal(clause_buffer);
+    clause_buffer.clear();
+}
+
+void CdclSolver::assume(int lit)
+{
+    Lit l = to_lit(lit);
+    ensure_var(var(l));
+    assumptions.push_back(l);
+}
+
+void CdclSolver::enqueue(Lit l, CRef from)
+{
+    int v = var(l);
+    lit_value[l] = 1;
+    lit_value[l ^ 1] = -1;
+    level[v] = decision_level();
+    reason[v] = from;
+    trail.push_back(l);
+}
+
+CdclSolver::CRef CdclSolver::propagate()
+{
+    CRef confl = CREF_UNDEF;
+
+    while(qhead < (int) trail.size()){
+        Lit p = trail[qhead++];
+        Lit false_lit = p ^ 1;
+        std::vector<Watcher>& ws = watches[p];
+
+        int i = 0, j = 0, n = (int) ws.size();
+        while(i < n){
+            Watcher w = ws[i++];
+
+            if(lit_value[w.blocker] == 1){
+                ws[j++] = w;
+                continue;
+            }
+
+            if(w.binary){
+                ws[j++] = w;
+                if(lit_value[w.blocker] == -1){
+                    confl = w.cref;
+                    qhead = (int) trail.size();
+                    while(i < n)    ws[j++] = ws[i++];
+                }
+                else{
+                    enqueue(w.blocker, w.cref);
+                }
+                continue;
+            }
+
+            if(is_deleted(w.cref))  continue;
+
+            Lit* c = clause_lits(w.cref);
+            if(c[0] == false_lit)   std::swap(c[0], c[1]);
+
+            Lit first = c[0];
+            Watcher nw = {w.cref, first, false};
+            if(first != w.blocker && lit_value[first] == 1){
+                ws[j++] = nw;
+                continue;
+            }
+
+            // look for a new literal to watch
+            int size = clause_size(w.cref);
+            bool found = false;
+            for(int k = 2; k < size; k++){
+                if(lit_value[c[k]] != -1){
+                    c[1] = c[k];
+                    c[k] = false_lit;
+                    watches[c[1] ^ 1].push_back(nw);
+                    found = true;
+                    break;
+                }
+            }
+            if(found)   continue;
+
+            // the clause is unit or conflicting
+            ws[j++] = nw;
+            if(lit_value[first] == -1){
+                confl = w.cref;
+                qhead = (int) trail.size();
+                while(i < n)    ws[j++] = ws[i++];
+            }
+            else{
+                enqueue(first, w.cref);
+            }
+        }
+        ws.resize(j);
+    }
+
+    return confl;
+}
+
+void CdclSolver::cancel_until(int lvl)
+{
+    if(decision_level() <= lvl) return;
+
+    for(int c = (int) trail.size() - 1; c >= trail_lim[lvl]; c--){
+        Lit l = trail[c];
+        int v = var(l);
+        lit_value[l] = 0;
+        lit_value[l ^ 1] = 0;
+        reason[v] = CREF_UNDEF;
+        polarity[v] = (char) (l & 1);
+        heap_insert(v);
+    }
+    qhead = trail_lim[lvl];
+    trail.resize(trail_lim[lvl]);
+    trail_lim.resize(lvl);
+}
+
+void CdclSolver::analyze(CRef confl, std::vector<Lit>& out_learnt, int& out_btlevel, int& out_lbd)
+{
+    int path_c = 0;
+    Lit p = -1;
+    int index = (int) trail.size() - 1;
+
+    out_learnt.clear();
+    out_learnt.push_back(-1); // room for the asserting literal
+
+    do{
+        if(arena[confl + 1] & FLAG_LEARNT) bump_clause(confl);
+
+        Lit* c = clause_lits(confl);
+        int size = clause_size(confl);
+        for(int k = 0; k < size; k++){
+            Lit q = c[k];
+            int v = var(q);
+            if(p != -1 && v == var(p))  continue;
+            if(seen[v] || level[v] == 0)    continue;
+
+            bump_var(v);
+            seen[v] = 1;
+            if(level[v] >= decision_level())    path_c++;
+            else                                out_learnt.push_back(q);
+        }
+
+        // next literal of the current level to look at
+        while(!seen[var(trail[index--])]);
+        p = trail[index + 1];
+        confl = reason[var(p)];
+        seen[var(p)] = 0;
+        path_c--;
+    } while(path_c > 0);
+
+    out_learnt[0] = p ^ 1;
+
+    // drop literals implied by the other literals of the clause
+    std::vector<Lit> to_clear(out_learnt);
+    int j = 1;
+    for(int i = 1; i < (int) out_learnt.size(); i++){
+        int v = var(out_learnt[i]);
+        CRef r = reason[v];
+        bool keep = r == CREF_UNDEF;
+        if(!keep){
+            Lit* c = clause_lits(r);
+            int size = clause_size(r);
+            for(int k = 0; k < size; k++){
+                int u = var(c[k]);
+                if(u != v && !seen[u] && level[u] > 0){
+                    keep = true;
+                    break;
+                }
+            }
+        }
+        if(keep)    out_learnt[j++] = out_learnt[i];
+    }
+    out_learnt.resize(j);
+
+    for(Lit l : to_clear)
+        seen[var(l)] = 0;
+
+    // the literal with the highest level goes to the second watch
+    out_btlevel = 0;
+    if(out_learnt.size() > 1){
+        int max_i = 1;
+        for(int i = 2; i < (int) out_learnt.size(); i++)
+            if(level[var(out_learnt[i])] > level[var(out_learnt[max_i])])
+                max_i = i;
+        std::swap(out_learnt[1], out_learnt[max_i]);
+        out_btlevel = level[var(out_learnt[1])];
+    }
+
+    stamp++;
+    out_lbd = 0;
+    for(Lit l : out_learnt){
+        int lvl = level[var(l)];
+        if(level_stamp[lvl] != stamp){
+            level_stamp[lvl] = stamp;
+            out_lbd++;
+        }
+    }
+}
+
+// collects the assumptions responsible for assumption p being false
+void CdclSolver::analyze_final(Lit p)
+{
+    failed_lits[p] = 1;
+    if(decision_level() == 0)   return;
+
+    seen[var(p)] = 1;
+    for(int i = (int) trail.size() - 1; i >= trail_lim[0]; i--){
+        int x = var(trail[i]);
+        if(!seen[x])    continue;
+
+        if(reason[x] == CREF_UNDEF){
+            failed_lits[trail[i]] = 1;
+        }
+        else{
+            Lit* c = clause_lits(reason[x]);
+            int size = clause_size(reason[x]);
+            for(int k = 0; k < size; k++)
+                if(var(c[k]) != x && level[var(c[k])] > 0)
+                    seen[var(c[k])] = 1;
+        }
+        seen[x] = 0;
+    }
+    seen[var(p)] = 0;
+}
+
+CdclSolver::Lit CdclSolver::pick_branch()
+{
+    while(!heap.empty()){
+        int v = heap_pop();
+        if(lit_value[2 * v] == 0)
+            return 2 * v + polarity[v];
+    }
+    return -1;
+}
+
+// returns SAT_SATISFIABLE, SAT_UNSATISFIABLE or SAT_UNKNOWN if the conflict budget ran out
+int CdclSolver::search(int n_conflicts)
+{
+    int conflicts = 0;
+    std::vector<Lit> learnt;
+
+    while(true){
+        CRef confl = propagate();
+
+        if(confl != CREF_UNDEF){
+            conflicts++;
+            if(decision_level() == 0){
+                ok = false;
+                return SAT_UNSATISFIABLE;
+            }
+
+            int bt_level, lbd;
+            analyze(confl, learnt, bt_level, lbd);
+            cancel_until(bt_level);
+
+            if(learnt.size() == 1){
+                enqueue(learnt[0], CREF_UNDEF);
+            }
+            else{
+                CRef c = alloc_clause(learnt, true, lbd);
+                learnts.push_back(c);
+                attach_clause(c);
+                bump_clause(c);
+                enqueue(learnt[0], c);
+            }
+
+            var_inc /= var_decay;
+            cla_inc /= clause_decay;
+            continue;
+        }
+
+        if(conflicts >= n_conflicts){
+            cancel_until(0);
+            return SAT_UNKNOWN;
+        }
+
+        if((double) learnts.size() - (double) trail.size() >= max_learnts)
+            reduce_db();
+
+        Lit next = -1;
+        while(decision_level() < (int) assumptions.size()){
+            Lit p = assumptions[decision_level()];
+            if(lit_value[p] == 1){
+                trail_lim.push_back((int) trail.size()); // dummy level
+            }
+            else if(lit_value[p] == -1){
+                analyze_final(p);
+                return SAT_UNSATISFIABLE;
+            }
+            else{
+                next = p;
+                break;
+            }
+        }
+
+        if(terminated()){
+            cancel_until(0);
+            return SAT_UNKNOWN;
+        }
+
+        if(next == -1){
+            next = pick_branch();
+            if(next == -1)  return SAT_SATISFIABLE;
+        }
+
+        trail_lim.push_back((int) trail.size());
+        enqueue(next, CREF_UNDEF);
+    }
+}
+
+void CdclSolver::reduce_db()
+{
+    std::sort(learnts.begin(), learnts.end(), [this](CRef a, CRef b){
+        if(arena[a + 2] != arena[b + 2])    return arena[a + 2] > arena[b + 2];
+        return clause_activity(a) < clause_activity(b);
+    });
+
+    int limit = (int) learnts.size() / 2;
+    int removed = 0;
+    int j = 0;
+    for(int i = 0; i < (int) learnts.size(); i++){
+        CRef c = learnts[i];
+        if(removed < limit && clause_size(c) > 2 && arena[c + 2] > 2 && !locked(c)){
+            arena[c + 1] |= FLAG_DELETED;
+            wasted += clause_size(c) + CLAUSE_HEADER;
+            removed++;
+        }
+        else{
+            learnts[j++] = c;
+        }
+    }
+    learnts.resize(j);
+}
+
+// compacts the arena, must be called at decision level 0
+void CdclSolver::collect_garbage()
+{
+    std::vector<int> compact;
+    compact.reserve(arena.size() - wasted);
+
+    std::vector<CRef>* lists[] = {&clauses, &learnts};
+    for(auto list : lists){
+        for(CRef& c : *list){
+            CRef nc = (CRef) compact.size();
+            compact.insert(compact.end(), arena.begin() + c,
+                           arena.begin() + c + CLAUSE_HEADER + clause_size(c));
+            c = nc;
+        }
+    }
+    arena.swap(compact);
+    wasted = 0;
+
+    // reasons of level 0 are never looked at again
+    for(Lit l : trail)
+        reason[var(l)] = CREF_UNDEF;
+
+    for(auto& ws : watches)
+        ws.clear();
+    for(CRef c : clauses)   attach_clause(c);
+    for(CRef c : learnts)   attach_clause(c);
+}
+
+int CdclSolver::solve()
+{
+    model.clear();
+    failed_lits.assign(lit_value.size(), 0);
+
+    int status = ok ? SAT_UNKNOWN : SAT_UNSATISFIABLE;
+    max_learnts = std::max(clauses.size() / 3.0, 5000.0);
+
+    for(int restarts = 0; status == SAT_UNKNOWN && !terminated(); restarts++){
+        status = search((int) (luby(2, restarts) * restart_base));
+        max_learnts *= learnts_growth;
+
+        if(status == SAT_UNKNOWN && wasted > (int) arena.size() / 2)
+            collect_garbage();
+    }
+
+    if(status == SAT_SATISFIABLE){
+        model.resize(n_vars());
+        for(int v = 0; v < n_vars(); v++)
+            model[v] = lit_value[2 * v];
+    }
+
+    cancel_until(0);
+    assumptions.clear();
+    return status;
+}
+
+int CdclSolver::val(int lit)
+{
+    int v = std::abs(lit) - 1;
+    bool value = v < (int) model.size() && model[v] == 1;
+    if(lit < 0) value = !value;
+    return value ? lit : -lit;
+}
+
+bool CdclSolver::failed(int lit)
+{
+    Lit l = to_lit(lit);
+    return l < (int) failed_lits.size() && failed_lits[l];
+}
+
+void CdclSolver::heap_insert(int v)
+{
+    if(heap_index[v] >= 0)  return;
+    heap_index[v] = (int) heap.size();
+    heap.push_back(v);
+    heap_up(heap_index[v]);
+}
+
+void CdclSolver::heap_up(int pos)
+{
+    int v = heap[pos];
+    while(pos > 0){
+        int parent = (pos - 1) >> 1;
+        if(activity[heap[parent]] >= activity[v])   break;
+        heap[pos] = heap[parent];
+        heap_index[heap[pos]] = pos;
+        pos = parent;
+    }
+    heap[pos] = v;
+    heap_index[v] = pos;
+}
+
+void CdclSolver::heap_down(int pos)
+{
+    int v = heap[pos];
+    int size = (int) heap.size();
+    while(2 * pos + 1 < size){
+        int child = 2 * pos + 1;
+        if(child + 1 < size && activity[heap[child + 1]] > activity[heap[child]])
+            child++;
+        if(activity[heap[child]] <= activity[v])    break;
+        heap[pos] = heap[child];
+        heap_index[heap[pos]] = pos;
+        pos = child;
+    }
+    heap[pos] = v;
+    heap_index[v] = pos;
+}
+
+int CdclSolver::heap_pop()
+{
+    int v = heap[0];
+    heap_index[v] = -1;
+    int last = heap.back();
+    heap.pop_back();
+    if(!heap.empty()){
+        heap[0] = last;
+        heap_index[last] = 0;
+        heap_down(0);
+    }
+    return v;
+}
+
+void CdclSolver::bump_var(int v)
+{
+    activity[v] += var_inc;
+    if(activity[v] > 1e100){
+        for(double& a : activity)
+            a *= 1e-100;
+        var_inc *= 1e-100;
+    }
+    if(heap_index[v] >= 0)
+        heap_up(heap_index[v]);
+}
+
+void CdclSolver::bump_clause(CRef c)
+{
+    float act = clause_activity(c) + (float) cla_inc;
+    set_clause_activity(c, act);
+    if(act > 1e20){
+        for(CRef l : learnts)
+            set_clause_activity(l, clause_activity(l) * 1e-20f);
+        cla_inc *= 1e-20;
+    }
+}
@@ -0,0 +1,150 @@
+//
+// Created by:
+//    Cauim de S. Lima - cauimsouza@gmail.com
+//    Victor Hugo Vianna Silva - victor.vianna10@gmail.com
+//
+
+#ifndef RIKUDOSOLVER_CDCL_SOLVER_H
+#define RIKUDOSOLVER_CDCL_SOLVER_H
+
+#include "sat_solver.h"
+#include <random>
+#include <vector>
+
+/**
+ * @brief In-process conflict driven clause learning SAT solver
+ * @details Classic MiniSat-like design: two watched literals, first UIP
+ * learning, VSIDS branching with phase saving, Luby restarts and periodic
+ * reduction of the learned clause database. Learned clauses are kept between
+ * calls to solve, so a sequence of queries over the same formula (e.g. under
+ * different assumptions) gets faster as the solver warms up.
+ */
+class CdclSolver : public SatSolver
+{
+private:
+    /**
+     * internal literal: 2 * variable + 1 if negated, variables start at 0
+     */
+    typedef int Lit;
+
+    /**
+     * clause reference: offset of the clause in 'arena'
+     */
+    typedef int CRef;
+    static const CRef CREF_UNDEF = -1;
+
+    /**
+     * layout of a clause in the arena: a header of CLAUSE_HEADER words
+     * (size, flags, lbd, activity) followed by its literals
+     */
+    static const int CLAUSE_HEADER = 4;
+    static const int FLAG_LEARNT = 1;
+    static const int FLAG_DELETED = 2;
+
+    struct Watcher
+    {
+        CRef cref;
+        Lit blocker;
+        bool binary;
+    };
+
+    std::vector<int> arena;
+    int wasted;
+    std::vector<CRef> clauses;
+    std::vector<CRef> learnts;
+
+    /**
+     * lit_value[l] is 1 if literal l is true, -1 if it is false and 0 if unassigned
+     */
+    std::vector<signed char> lit_value;
+    std::vector<int> level;
+    std::vector<CRef> reason;
+    std::vector<double> activity;
+    std::vector<char> polarity;
+    std::vector<char> seen;
+
+    /**
+     * watches[l] lists the clauses watching the negation of l, i.e. the clauses
+     * to be visited when l becomes true
+     */
+    std::vector< std::vector<Watcher> > watches;
+
+    std::vector<Lit> trail;
+    std::vector<int> trail_lim;
+    int qhead;
+
+    /**
+     * binary max-heap of unassigned variables ordered by activity
+     */
+    std::vector<int> heap;
+    std::vector<int> heap_index;
+
+    double var_inc;
+    double cla_inc;
+    double max_learnts;
+    bool ok;
+
+    std::vector<Lit> clause_buffer;
+    std::vector<Lit> assumptions;
+    std::vector<char> failed_lits;
+    std::vector<signed char> model;
+    std::vector<int> level_stamp;
+    int stamp;
+
+    /**
+     * 0 for the deterministic default, otherwise the initial phases and the order of
+     * the first decisions are drawn from rng
+     */
+    unsigned seed;
+    std::mt19937 rng;
+
+    static Lit to_lit(int dimacs);
+    static int var(Lit l) { return l >> 1; }
+
+    int n_vars() const { return (int) level.size(); }
+    int decision_level() const { return (int) trail_lim.size(); }
+    void ensure_var(int v);
+
+    int clause_size(CRef c) const { return arena[c]; }
+    Lit* clause_lits(CRef c) { return &arena[c + CLAUSE_HEADER]; }
+    bool is_deleted(CRef c) const { return (arena[c + 1] & FLAG_DELETED) != 0; }
+    float clause_activity(CRef c) const;
+    void set_clause_activity(CRef c, float act);
+    bool locked(CRef c);
+
+    CRef alloc_clause(const std::vector<Lit>& lits, bool learnt, int lbd);
+    void attach_clause(CRef c);
+    void add_internal(std::vector<Lit>& lits);
+
+    void enqueue(Lit l, CRef from);
+    CRef propagate();
+    void cancel_until(int lvl);
+    void analyze(CRef confl, std::vector<Lit>& out_learnt, int& out_btlevel, int& out_lbd);
+    void analyze_final(Lit p);
+    Lit pick_branch();
+    int search(int n_conflicts);
+    void reduce_db();
+    void collect_garbage();
+
+    void heap_insert(int v);
+    void heap_up(int pos);
+    void heap_down(int pos);
+    int heap_pop();
+    void bump_var(int v);
+    void bump_clause(CRef c);
+
+public:
+    /**
+     * @param seed seed of the initial phases and branching order, different seeds
+     * explore the search space differently, 0 keeps the default
+     */
+    explicit CdclSolver(unsigned seed = 0);
+
+    void add(int lit);
+    void assume(int lit);
+    int solve();
+    int val(int lit);
+    bool failed(int lit);
+};
+
+#endif //RIKUDOSOLVER_CDCL_SOLVER_H
@@ -0,0 +1,374 @@
+//
+// Created by:
+//    Cauim de S. Lima - cauimsouza@gmail.com
+//    Victor Hugo Vianna Silva - victor.vianna10@gmail.com
+//
+
+#include "decomposition.h"
+#include "endpoint_filter.h"
+#include <algorithm>
+#include <thread>
+
+// necks leaving a side with fewer vertices are not split at: so small a side is no
+// cheaper to solve apart, while the block left is a different and often harder formula
+#define min_side_size 8
+
+
+namespace
+{
+    // cut vertices of the graph without vertex removed (Tarjan's low points)
+    std::vector<int> cut_vertices(const std::vector< std::vector<int> >& adj_list, int removed)
+    {
+        int n = adj_list.size();
+        std::vector<int> order(n, -1), low(n, 0), cuts;
+        std::vector<bool> is_cut(n, false);
+        int time = 0;
+
+        std::function<void(int, int)> dfs = [&](int v, int parent){
+            order[v] = low[v] = time++;
+            int n_children = 0;
+            for(int w : adj_list[v]){
+                if(w == removed || w == parent) continue;
+                if(order[w] != -1){
+                    low[v] = std::min(low[v], order[w]);
+                    continue;
+                }
+                n_children++;
+                dfs(w, v);
+                low[v] = std::min(low[v], low[w]);
+                if(parent != -1 && low[w] >= order[v])  is_cut[v] = true;
+            }
+            if(parent == -1 && n_children > 1)  is_cut[v] = true;
+        };
+        for(int v = 0; v < n; v++)
+            if(v != removed && order[v] == -1)  dfs(v, -1);
+
+        for(int v = 0; v < n; v++)
+            if(is_cut[v])   cuts.push_back(v);
+        return cuts;
+    }
+
+    // component of every vertex once some are removed, -1 for the removed ones
+    int components(const std::vector< std::vector<int> >& adj_list, const std::vector<int>& removed,
+                   std::vector<int>& component)
+    {
+        int n = adj_list.size();
+        component.assign(n, -2);
+        for(int v : removed)
+            component[v] = -1;
+
+        int n_components = 0;
+        std::vector<int> bfs;
+        for(int v = 0; v < n; v++){
+            if(component[v] != -2)  continue;
+            component[v] = n_components;
+            bfs.assign(1, v);
+            for(int i = 0; i < (int) bfs.size(); i++)
+                for(int w : adj_list[bfs[i]])
+                    if(component[w] == -2){
+                        component[w] = n_components;
+                        bfs.push_back(w);
+                    }
+            n_components++;
+        }
+        return n_components;
+    }
+
+    // vertices of some components, plus extra vertices
+    std::vector<int> gather(const std::vector<int>& component, std::initializer_list<int> wanted,
+                            std::initializer_list<int> extra)
+    {
+        std::vector<int> vertices(extra);
+        for(int v = 0; v < (int) component.size(); v++)
+            for(int c : wanted)
+                if(component[v] == c)   vertices.push_back(v);
+        return vertices;
+    }
+}
+
+
+Decomposition::Decomposition(const std::vector< std::vector<int> >& adj_list, int n_threads)
+    : adj_list(adj_list), solver(nullptr), n_threads(std::max(n_threads, 1)),
+      n_spare_threads(0), next_label(0), n_blocks(0)
+{
+    // the lists are made simple so that pieces are built from them directly
+    for(int u = 0; u < (int) this->adj_list.size(); u++){
+        auto& list = this->adj_list[u];
+        list.erase(std::remove(list.begin(), list.end(), u), list.end());
+        std::sort(list.begin(), list.end());
+        list.erase(std::unique(list.begin(), list.end()), list.end());
+    }
+}
+
+Decomposition::Piece Decomposition::sub_piece(const Piece& piece, const std::vector<int>& vertices,
+                                              int source, int target, int cut_u, int cut_v)
+{
+    std::vector<int> local(piece.adj_list.size(), -1);
+    for(int i = 0; i < (int) vertices.size(); i++)
+        local[vertices[i]] = i;
+
+    Piece sub;
+    sub.adj_list.assign(vertices.size(), std::vector<int>());
+    for(int v : vertices){
+        sub.label.push_back(piece.label[v]);
+        for(int w : piece.adj_list[v]){
+            bool cut = (v == cut_u && w == cut_v) || (v == cut_v && w == cut_u);
+            if(local[w] != -1 && !cut)
+                sub.adj_list[local[v]].push_back(local[w]);
+        }
+    }
+    sub.source = local[source];
+    sub.target = local[target];
+    return sub;
+}
+
+bool Decomposition::find_splits(const Piece& piece, std::vector<Split>& splits)
+{
+    const auto& adj = piece.adj_list;
+    int n = adj.size();
+    int s = piece.source, t = piece.target;
+    splits.clear();
+    if(n < 2 * min_side_size + 1 || s == t)    return false;
+
+    std::vector<int> component;
+
+    // a cut vertex, the one leaving the largest smaller side
+    int best_cut = -1, best_size = min_side_size - 1;
+    for(int c : cut_vertices(adj, -1)){
+        int k = components(adj, {c}, component);
+        std::vector<int> size(k, 0);
+        for(int v = 0; v < n; v++)
+            if(component[v] >= 0)   size[component[v]]++;
+        int smallest = *std::min_element(size.begin(), size.end());
+        if(smallest > best_size){
+            best_cut = c;
+            best_size = smallest;
+        }
+    }
+    if(best_cut != -1){
+        int c = best_cut;
+        int k = components(adj, {c}, component);
+        if(c == s || c == t || k > 2 || component[s] == component[t])
+            return true;
+        Split split;
+        split.parts.push_back(sub_piece(piece, gather(component, {component[s]}, {c}), s, c));
+        split.parts.push_back(sub_piece(piece, gather(component, {component[t]}, {c}), c, t));
+        split.lobe = -1;
+        splits.push_back(split);
+        return true;
+    }
+
+    // a separator {a, b}, the one leaving the largest smallest component
+    int best_a = -1, best_b = -1;
+    best_size = min_side_size - 1;
+    for(int a = 0; a < n; a++)
+        for(int b : cut_vertices(adj, a)){
+            if(b < a)   continue;
+            int k = components(adj, {a, b}, component);
+            std::vector<int> size(k, 0);
+            for(int v = 0; v < n; v++)
+                if(component[v] >= 0)   size[component[v]]++;
+            int smallest = *std::min_element(size.begin(), size.end());
+            if(smallest > best_size){
+                best_a = a;
+                best_b = b;
+                best_size = smallest;
+            }
+        }
+    if(best_a == -1)    return false;
+
+    int a = best_a, b = best_b;
+    int k = components(adj, {a, b}, component);
+    bool s_in = s == a || s == b;
+    bool t_in = t == a || t == b;
+
+    if(s_in && t_in)    return true;
+    if(s_in || t_in){
+        // the path is e, then the component without the other endpoint f, then o, then
+        // the component of f
+        if(k > 2)   return true;
+        int e = s_in ? s : t;
+        int o = e == a ? b : a;
+        int f = s_in ? t : s;
+        int cf = component[f];
+        std::vector<int> near = gather(component, {1 - cf}, {e, o});
+        std::vector<int> far = gather(component, {cf}, {o});
+        Split split;
+        split.lobe = -1;
+        if(s_in){
+            split.parts.push_back(sub_piece(piece, near, e, o));
+            split.parts.push_back(sub_piece(piece, far, o, f));
+        }
+        else{
+            split.parts.push_back(sub_piece(piece, far, f, o));
+            split.parts.push_back(sub_piece(piece, near, o, e));
+        }
+        splits.push_back(split);
+        return true;
+    }
+
+    int cs = component[s], ct = component[t];
+    if(k > 3 || (k == 3 && cs == ct))   return true;
+
+    if(k == 3){
+        // the third component is crossed from a to b or from b to a
+        int cm = 3 - cs - ct;
+        for(int x : {a, b}){
+            int y = x == a ? b : a;
+            Split split;
+            split.lobe = -1;
+            split.parts.push_back(sub_piece(piece, gather(component, {cs}, {x}), s, x));
+            split.parts.push_back(sub_piece(piece, gather(component, {cm}, {x, y}), x, y, x, y));
+            split.parts.push_back(sub_piece(piece, gather(component, {ct}, {y}), y, t));
+            splits.push_back(split);
+        }
+        return true;
+    }
+
+    if(cs == ct){
+        // the other component is a lobe, replaced by a vertex adjacent to a and b only
+        int cl = 1 - cs;
+        Piece rest = sub_piece(piece, gather(component, {cs}, {a, b}), s, t);
+        int lobe = rest.adj_list.size();
+        rest.adj_list.push_back({0, 1});
+        rest.adj_list[0].push_back(lobe);
+        rest.adj_list[1].push_back(lobe);
+        rest.label.push_back(next_label++);
+
+        Split split;
+        split.lobe = rest.label.back();
+        split.parts.push_back(rest);
+        split.parts.push_back(sub_piece(piece, gather(component, {cl}, {a, b}), a, b, a, b));
+        splits.push_back(split);
+        return true;
+    }
+
+    // the path leaves the component of s for the last time through h, the other vertex
+    // of the separator being visited before or after it
+    for(int h : {b, a}){
+        int g = h == a ? b : a;
+        Split before, after;
+        before.lobe = after.lobe = -1;
+        before.parts.push_back(sub_piece(piece, gather(component, {cs}, {g, h}), s, h));
+        before.parts.push_back(sub_piece(piece, gather(component, {ct}, {h}), h, t));
+        after.parts.push_back(sub_piece(piece, gather(component, {cs}, {h}), s, h));
+        after.parts.push_back(sub_piece(piece, gather(component, {ct}, {h, g}), h, t));
+        splits.push_back(before);
+        splits.push_back(after);
+    }
+    return true;
+}
+
+bool Decomposition::may_solve(const Split& split)
+{
+    for(auto& part : split.parts)
+        if(!EndpointFilter(part.adj_list).may_join(part.source, part.target))
+            return false;
+    return true;
+}
+
+std::vector<int> Decomposition::solve_piece(const Piece& piece)
+{
+    std::vector<Split> splits;
+    if(find_splits(piece, splits))
+        return solve_splits(splits);
+
+    n_blocks++;
+    std::vector<int> found = (*solver)(piece.adj_list, piece.source, piece.target);
+    std::vector<int> path;
+    for(int v : found)
+        path.push_back(piece.label[v]);
+    return path;
+}
+
+std::vector<int> Decomposition::solve_splits(const std::vector<Split>& splits)
+{
+    for(auto& split : splits){
+        // alternatives the endpoint rules rule out are not searched
+        if(!may_solve(split))   continue;
+
+        // every part but the first on a spare thread, if any
+        int n_parts = split.parts.size();
+        std::vector< std::vector<int> > paths(n_parts);
+        std::vector<std::thread> threads;
+        std::vector<int> spawned;
+        for(int i = 1; i < n_parts; i++){
+            if(n_spare_threads.fetch_sub(1) > 0){
+                spawned.push_back(i);
+                threads.emplace_back([this, &split, &paths, i](){
+                    paths[i] = solve_piece(split.parts[i]);
+                });
+            }
+            else{
+                n_spare_threads++;
+            }
+        }
+        bool solved = true;
+        for(int i = 0; i < n_parts && solved; i++){
+            if(std::find(spawned.begin(), spawned.end(), i) != spawned.end())  continue;
+            paths[i] = solve_piece(split.parts[i]);
+            solved = !paths[i].empty();
+        }
+        for(auto& thread : threads){
+            thread.join();
+            n_spare_threads++;
+        }
+        for(auto& p : paths)
+            if(p.empty())   solved = false;
+        if(!solved) continue;
+
+        int n_chain = split.lobe == -1 ? n_parts : n_parts - 1;
+        std::vector<int> path(paths[0]);
+        for(int i = 1; i < n_chain; i++)
+            path.insert(path.end(), paths[i].begin() + 1, paths[i].end());
+
+        if(split.lobe != -1){
+            // the lobe vertex is between a and b, the lobe path goes from a to b
+            const std::vector<int>& lobe = paths.back();
+            auto it = std::find(path.begin(), path.end(), split.lobe);
+            int i = it - path.begin();
+            std::vector<int> inner(lobe.begin() + 1, lobe.end() - 1);
+            if(path[i - 1] != lobe.front())
+                std::reverse(inner.begin(), inner.end());
+            path.erase(it);
+            path.insert(path.begin() + i, inner.begin(), inner.end());
+        }
+        return path;
+    }
+    return std::vector<int>();
+}
+
+bool Decomposition::solve(int source, int target, const BlockSolver& solver, std::vector<int>& path)
+{
+    int n = adj_list.size();
+    path.clear();
+    n_blocks = 0;
+    if(source < 0 || source >= n || target < 0 || target >= n)
+        return false;
+    for(int u = 0; u < n; u++)
+        for(int v : adj_list[u])
+            if(!std::binary_search(adj_list[v].begin(), adj_list[v].end(), u))
+                return false;
+
+    // a disconnected graph is left to the solver, which tells it at once
+    std::vector<int> component;
+    if(components(adj_list, {}, component) != 1)
+        return false;
+
+    Piece whole;
+    whole.adj_list = adj_list;
+    for(int v = 0; v < n; v++)
+        whole.label.push_back(v);
+    whole.source = source;
+    whole.target = target;
+
+    next_label = n;
+    std::vector<Split> splits;
+    if(!find_splits(whole, splits))
+        return false;
+
+    this->solver = &solver;
+    n_spare_threads = n_threads - 1;
+    path = solve_splits(splits);
+    return true;
+}
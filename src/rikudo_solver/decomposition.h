@@ -0,0 +1,117 @@
+//
+// Created by:
+//    Cauim de S. Lima - cauimsouza@gmail.com
+//    Victor Hugo Vianna Silva - victor.vianna10@gmail.com
+//
+
+#ifndef RIKUDOSOLVER_DECOMPOSITION_H
+#define RIKUDOSOLVER_DECOMPOSITION_H
+
+#include <atomic>
+#include <functional>
+#include <vector>
+
+/**
+ * @brief Function finding a hamiltonian path of a block from source to target, returning
+ * it or an empty path if there is none
+ */
+typedef std::function<std::vector<int>(const std::vector< std::vector<int> >& adj_list,
+                                       int source, int target)> BlockSolver;
+
+/**
+ * @brief Splits the search of a hamiltonian path of an undirected graph at its narrow
+ * necks, solving the blocks independently and stitching their paths
+ * @details A path crosses a neck in a fixed way:
+ * - at a cut vertex c leaving two components, the endpoints are on different sides and
+ * the path is a path from the source to c on one side followed by one from c to the
+ * target on the other,
+ * - at a separator {a, b}, each component is visited in at most three runs between a and
+ * b. A component without endpoints is a lobe, a path from a to b on it replaces a
+ * vertex adjacent to a and b only in the rest of the graph; components holding the
+ * endpoints give a few ways of sharing a and b, tried in turn.
+ * Only necks leaving at least a few vertices on each side are split at. The alternatives
+ * are checked with the rules of EndpointFilter before being searched, and the blocks are
+ * split again until none has a neck and solved on up to n_threads threads.
+ */
+class Decomposition
+{
+private:
+    /**
+     * part of the graph, with the vertex of the graph each vertex stands for; labels
+     * from the number of vertices of the graph on stand for lobes
+     */
+    struct Piece
+    {
+        std::vector< std::vector<int> > adj_list;
+        std::vector<int> label;
+        int source;
+        int target;
+    };
+
+    /**
+     * the parts a path of a piece splits into, when each is solved with its endpoints
+     * and stitched, and the lobe vertex replaced by the path of the last part if any
+     */
+    struct Split
+    {
+        std::vector<Piece> parts;
+        int lobe;
+    };
+
+    std::vector< std::vector<int> > adj_list;
+    const BlockSolver* solver;
+    int n_threads;
+
+    std::atomic<int> n_spare_threads;
+    std::atomic<int> next_label;
+    std::atomic<int> n_blocks;
+
+    static Piece sub_piece(const Piece& piece, const std::vector<int>& vertices,
+                           int source, int target, int cut_u = -1, int cut_v = -1);
+
+    /**
+     * @brief Finds the ways a path of a piece may split at its best neck
+     *
+     * @param splits set to the alternatives, one of which holds every path
+     * @return false if the piece has no neck, true otherwise, splits being empty
+     * when the neck admits no path
+     */
+    bool find_splits(const Piece& piece, std::vector<Split>& splits);
+
+    /**
+     * @return false if the endpoint rules tell that some part of the split has no path
+     */
+    static bool may_solve(const Split& split);
+
+    std::vector<int> solve_piece(const Piece& piece);
+
+    /**
+     * @brief Tries the alternatives of a neck in turn, returning the first path found
+     */
+    std::vector<int> solve_splits(const std::vector<Split>& splits);
+
+public:
+    /**
+     * @param adj_list adjacence list of an undirected graph
+     * @param n_threads number of threads solving blocks at the same time
+     */
+    Decomposition(const std::vector< std::vector<int> >& adj_list, int n_threads);
+
+    /**
+     * @brief Finds a hamiltonian path from source to target block by block
+     *
+     * @param source origin of the path
+     * @param target destination of the path
+     * @param solver solves the blocks without necks
+     * @param path set to the path found, or empty if there is none
+     * @return false if the graph has no neck to split at, path being then left empty
+     */
+    bool solve(int source, int target, const BlockSolver& solver, std::vector<int>& path);
+
+    /**
+     * @return number of blocks given to the solver by the last call to solve
+     */
+    int get_n_blocks() const { return n_blocks; }
+};
+
+#endif //RIKUDOSOLVER_DECOMPOSITION_H
@@ -0,0 +1,337 @@
+//
+// Created by:
+//    Cauim de S. Lima - cauimsouza@gmail.com
+//    Victor Hugo Vianna Silva - victor.vianna10@gmail.com
+//
+
+#include "deduction.h"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+
+#define edge_unknown 0
+#define edge_in 1
+#define edge_out -1
+
+
+Deduction::Deduction(const std::vector< std::vector<int> >& adj_list)
+    : n_vertices(adj_list.size()), symmetric(true), source(-1), last(-1),
+      changed(false), contradiction(false)
+{
+    std::vector< std::vector<int> > sorted(adj_list);
+    for(auto& neighbors : sorted){
+        std::sort(neighbors.begin(), neighbors.end());
+        neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+    }
+
+    incident.assign(n_vertices, std::vector< std::pair<int,int> >());
+    for(int u = 0; u < n_vertices; u++)
+        for(int v : sorted[u]){
+            if(!std::binary_search(sorted[v].begin(), sorted[v].end(), u))
+                symmetric = false;
+            if(u >= v)  continue;
+            int e = edges.size();
+            edges.push_back(std::make_pair(u, v));
+            incident[u].push_back(std::make_pair(v, e));
+            incident[v].push_back(std::make_pair(u, e));
+        }
+}
+
+void Deduction::set_edge(int e, signed char state)
+{
+    if(edge_state[e] == state)  return;
+    if(edge_state[e] != edge_unknown){
+        contradiction = true;
+        return;
+    }
+    edge_state[e] = state;
+    changed = true;
+}
+
+void Deduction::fix(int v, int ith)
+{
+    if(!dom[v][ith]){
+        contradiction = true;
+        return;
+    }
+    for(int i = 0; i < n_vertices; i++)
+        if(i != ith && dom[v][i]){
+            dom[v][i] = 0;
+            changed = true;
+        }
+}
+
+// distances from a vertex using the edges not out of the path
+void Deduction::bfs(int from, std::vector<int>& dist)
+{
+    dist.assign(n_vertices, INT_MAX);
+    std::vector<int> queue(1, from);
+    dist[from] = 0;
+    for(int i = 0; i < (int) queue.size(); i++){
+        int u = queue[i];
+        for(auto w_e : incident[u]){
+            int w = w_e.first;
+            if(edge_state[w_e.second] == edge_out || dist[w] != INT_MAX)   continue;
+            dist[w] = dist[u] + 1;
+            queue.push_back(w);
+        }
+    }
+}
+
+// a vertex has two edges in the path, or one if it is an endpoint
+void Deduction::degree_rule()
+{
+    for(int v = 0; v < n_vertices && !contradiction; v++){
+        int needed = (v == source || v == last) ? 1 : 2;
+        int available = 0;
+        int in = 0;
+        for(auto w_e : incident[v]){
+            if(edge_state[w_e.second] != edge_out)  available++;
+            if(edge_state[w_e.second] == edge_in)   in++;
+        }
+
+        if(in > needed || available < needed){
+            contradiction = true;
+        }
+        else if(available == needed){
+            for(auto w_e : incident[v])
+                if(edge_state[w_e.second] == edge_unknown)  set_edge(w_e.second, edge_in);
+        }
+        else if(in == needed){
+            for(auto w_e : incident[v])
+                if(edge_state[w_e.second] == edge_unknown)  set_edge(w_e.second, edge_out);
+        }
+    }
+}
+
+// the edges in the path form fragments of path, returns true if the fragment of
+// the source is the whole path
+bool Deduction::fragment_rule()
+{
+    std::vector<int> root(n_vertices);
+    std::vector<int> size(n_vertices, 1);
+    for(int v = 0; v < n_vertices; v++)
+        root[v] = v;
+    auto find = [&root](int v){
+        while(root[v] != v)
+            v = root[v] = root[root[v]];
+        return v;
+    };
+
+    for(int e = 0; e < (int) edges.size(); e++){
+        if(edge_state[e] != edge_in)    continue;
+        int a = find(edges[e].first);
+        int b = find(edges[e].second);
+        if(a == b){
+            contradiction = true;
+            return false;
+        }
+        if(size[a] < size[b])   std::swap(a, b);
+        root[b] = a;
+        size[a] += size[b];
+    }
+
+    int rs = find(source);
+    int rt = find(last);
+    if(rs == rt)
+        return size[rs] == n_vertices;
+
+    for(int e = 0; e < (int) edges.size(); e++){
+        if(edge_state[e] != edge_unknown)   continue;
+        int a = find(edges[e].first);
+        int b = find(edges[e].second);
+        bool early_end = ((a == rs && b == rt) || (a == rt && b == rs)) &&
+                         size[a] + size[b] < n_vertices;
+        if(a == b || early_end) set_edge(e, edge_out);
+    }
+    return false;
+}
+
+// positions are bounded by the distances to the endpoints and to the fixed vertices
+void Deduction::distance_rule()
+{
+    std::vector<int> dist_s, dist_t;
+    bfs(source, dist_s);
+    bfs(last, dist_t);
+    for(int v = 0; v < n_vertices; v++){
+        if(dist_s[v] == INT_MAX){
+            contradiction = true;
+            return;
+        }
+        for(int i = 0; i < n_vertices; i++)
+            if(dom[v][i] && (i < dist_s[v] || i > n_vertices - 1 - dist_t[v])){
+                dom[v][i] = 0;
+                changed = true;
+            }
+    }
+
+    std::vector<int> dist;
+    for(int u = 0; u < n_vertices; u++){
+        if(u == source || u == last)    continue;
+        int p = std::find(dom[u].begin(), dom[u].end(), 1) - dom[u].begin();
+        if(p == n_vertices || std::count(dom[u].begin(), dom[u].end(), 1) != 1)
+            continue;
+        bfs(u, dist);
+        for(int v = 0; v < n_vertices; v++){
+            if(v == u)  continue;
+            for(int i = std::max(0, p - dist[v] + 1); i < n_vertices && i < p + dist[v]; i++)
+                if(dom[v][i]){
+                    dom[v][i] = 0;
+                    changed = true;
+                }
+        }
+    }
+}
+
+// the ends of an edge in the path are visited consecutively, and every position
+// is taken by exactly one vertex
+void Deduction::position_rule()
+{
+    int n = n_vertices;
+    auto next_to = [n](const std::vector<char>& d, int i){
+        return (i > 0 && d[i-1]) || (i < n - 1 && d[i+1]);
+    };
+
+    for(int e = 0; e < (int) edges.size(); e++){
+        int u = edges[e].first;
+        int v = edges[e].second;
+        if(edge_state[e] == edge_in){
+            for(int i = 0; i < n; i++){
+                if(dom[u][i] && !next_to(dom[v], i)){ dom[u][i] = 0; changed = true; }
+                if(dom[v][i] && !next_to(dom[u], i)){ dom[v][i] = 0; changed = true; }
+            }
+        }
+        else if(edge_state[e] == edge_unknown){
+            bool possible = false;
+            for(int i = 0; i < n && !possible; i++)
+                possible = dom[u][i] && next_to(dom[v], i);
+            if(!possible)   set_edge(e, edge_out);
+        }
+    }
+
+    std::vector<int> holder(n, -1);
+    std::vector<int> n_holders(n, 0);
+    for(int v = 0; v < n; v++){
+        int size = 0;
+        int pos = -1;
+        for(int i = 0; i < n; i++)
+            if(dom[v][i]){
+                size++;
+                pos = i;
+                n_holders[i]++;
+                holder[i] = v;
+            }
+        if(size == 0){
+            contradiction = true;
+            return;
+        }
+        if(size == 1){
+            for(int w = 0; w < n; w++)
+                if(w != v && dom[w][pos]){
+                    dom[w][pos] = 0;
+                    changed = true;
+                }
+        }
+    }
+
+    for(int i = 0; i < n && !contradiction; i++){
+        if(n_holders[i] == 0)       contradiction = true;
+        else if(n_holders[i] == 1)  fix(holder[i], i);
+    }
+}
+
+Deduced Deduction::deduce(int source, int last,
+                          const std::vector< std::pair<int,int> >& map,
+                          const std::vector< std::pair<int,int> >& diamonds)
+{
+    int n = n_vertices;
+    this->source = source;
+    this->last = last;
+    path.clear();
+    contradiction = false;
+    edge_state.assign(edges.size(), edge_unknown);
+    dom.assign(n, std::vector<char>(n, 1));
+
+    if(n == 0 || source < 0 || source >= n || last < 0 || last >= n)
+        return Deduced::CONTRADICTION;
+    for(auto ith_vertex : map)
+        if(ith_vertex.first < 0 || ith_vertex.first >= n ||
+           ith_vertex.second < 0 || ith_vertex.second >= n)
+            return Deduced::CONTRADICTION;
+
+    fix(source, 0);
+    fix(last, n - 1);
+    for(auto ith_vertex : map)
+        fix(ith_vertex.second, ith_vertex.first);
+    if(contradiction)   return Deduced::CONTRADICTION;
+
+    if(n == 1){
+        if(!diamonds.empty())   return Deduced::CONTRADICTION;
+        path.push_back(source);
+        return Deduced::PATH;
+    }
+    if(source == last)  return Deduced::CONTRADICTION;
+    if(!symmetric)      return Deduced::PARTIAL;
+
+    for(auto u_v : diamonds){
+        int u = u_v.first;
+        int v = u_v.second;
+        if(u < 0 || u >= n || v < 0 || v >= n)  return Deduced::CONTRADICTION;
+        auto it = std::find_if(incident[u].begin(), incident[u].end(),
+                               [v](const std::pair<int,int>& w_e){ return w_e.first == v; });
+        if(it == incident[u].end()) return Deduced::CONTRADICTION;
+        set_edge(it->second, edge_in);
+    }
+
+    do{
+        changed = false;
+        if(!contradiction)  degree_rule();
+        if(!contradiction && fragment_rule())   break;
+        if(!contradiction)  distance_rule();
+        if(!contradiction)  position_rule();
+        if(contradiction)   return Deduced::CONTRADICTION;
+    } while(changed);
+
+    if(contradiction)   return Deduced::CONTRADICTION;
+
+    // the edges in the path go from source to last through every vertex
+    int prev = -1;
+    int v = source;
+    while(true){
+        path.push_back(v);
+        int next = -1;
+        for(auto w_e : incident[v])
+            if(edge_state[w_e.second] == edge_in && w_e.first != prev)  next = w_e.first;
+        if(next == -1)  break;
+        prev = v;
+        v = next;
+    }
+    if((int) path.size() != n){
+        path.clear();
+        return Deduced::PARTIAL;
+    }
+
+    for(int i = 0; i < n; i++)
+        if(!dom[path[i]][i]){
+            path.clear();
+            return Deduced::CONTRADICTION;
+        }
+
+    return Deduced::PATH;
+}
+
+const std::vector<int>& Deduction::get_path() const
+{
+    return path;
+}
+
+std::vector< std::pair<int,int> > Deduction::get_fixed() const
+{
+    std::vector< std::pair<int,int> > fixed;
+    for(int v = 0; v < (int) dom.size(); v++){
+        if(std::count(dom[v].begin(), dom[v].end(), 1) != 1)    continue;
+        int ith = std::find(dom[v].begin(), dom[v].end(), 1) - dom[v].begin();
+        fixed.push_back(std::make_pair(ith, v));
+    }
+    return fixed;
+}
@@ -0,0 +1,110 @@
+//
+// Created by:
+//    Cauim de S. Lima - cauimsouza@gmail.com
+//    Victor Hugo Vianna Silva - victor.vianna10@gmail.com
+//
+
+#ifndef RIKUDOSOLVER_DEDUCTION_H
+#define RIKUDOSOLVER_DEDUCTION_H
+
+#include <utility>
+#include <vector>
+
+/**
+ * Outcome of Deduction::deduce
+ */
+enum class Deduced
+{
+    PATH,           // the rules determine the whole path, which is then the only solution
+    CONTRADICTION,  // the constraints admit no path
+    PARTIAL         // some edges and positions are known, search is still needed
+};
+
+/**
+ * @brief Applies Rikudo deduction rules to a fixpoint, without any search
+ * @details Every edge is either unknown, in the path or out of it, and every vertex
+ * has a domain of possible positions. The rules are
+ * - a vertex needs two edges in the path, one for the endpoints: when only that many
+ * are left they are all in, and once it has them the others are out,
+ * - diamonds are edges in the path,
+ * - an edge closing a cycle, or joining the endpoints before every vertex is covered, is out,
+ * - a vertex at distance d from the source (from last) is not visited before instant d
+ * (after instant n-1-d), and a vertex fixed at instant p pins the positions of the others
+ * by their distance to it,
+ * - the ends of an edge in the path are at consecutive positions, and an edge whose ends
+ * cannot be is out,
+ * - a position belongs to a single vertex, and a position possible for a single vertex
+ * fixes it.
+ * Each rule only removes options that no solution uses, so when the edges in the path
+ * form a hamiltonian path, it is the unique solution. Only undirected graphs are handled.
+ */
+class Deduction
+{
+private:
+    int n_vertices;
+    bool symmetric;
+
+    /**
+     * ends of every edge, and for every vertex its (neighbor, edge) pairs
+     */
+    std::vector< std::pair<int,int> > edges;
+    std::vector< std::vector< std::pair<int,int> > > incident;
+
+    /**
+     * state of every edge: unknown, in or out of the path
+     */
+    std::vector<signed char> edge_state;
+
+    /**
+     * dom[v][i] is true if vertex v may be visited at instant i
+     */
+    std::vector< std::vector<char> > dom;
+
+    int source;
+    int last;
+    bool changed;
+    bool contradiction;
+
+    std::vector<int> path;
+
+    void set_edge(int e, signed char state);
+    void fix(int v, int ith);
+    void bfs(int from, std::vector<int>& dist);
+
+    void degree_rule();
+    bool fragment_rule();
+    void distance_rule();
+    void position_rule();
+
+public:
+    explicit Deduction(const std::vector< std::vector<int> >& adj_list);
+
+    /**
+     * @brief Deduces what it can about the hamiltonian paths from source to last
+     * respecting the constraints
+     *
+     * @param source origin of the paths
+     * @param last destination of the paths
+     * @param map list of pairs of integers of the form (i, v) representing
+     * the condition "vertex v must be visited at instant i"
+     * @param diamonds list of diamonds in the form of a list of pairs of integers of the form (u, v) representing
+     * the condition "vertex v and vertex u must be visited consecutively, in any order"
+     * @return whether the path was found, the constraints contradict each other, or neither
+     */
+    Deduced deduce(int source, int last,
+                   const std::vector< std::pair<int,int> >& map,
+                   const std::vector< std::pair<int,int> >& diamonds);
+
+    /**
+     * @return the path found by the last call to deduce, if it returned PATH
+     */
+    const std::vector<int>& get_path() const;
+
+    /**
+     * @return the pairs (i, v) such that the last call to deduce proved that vertex v
+     * is visited at instant i
+     */
+    std::vector< std::pair<int,int> > get_fixed() const;
+};
+
+#endif //RIKUDOSOLVER_DEDUCTION_H
@@ -0,0 +1,89 @@
+//
+// Created by:
+//    Cauim de S. Lima - cauimsouza@gmail.com
+//    Victor Hugo Vianna Silva - victor.vianna10@gmail.com
+//
+
+#include "dimacs_writer.h"
+#include <cstdlib>
+
+
+#define buffer_size (1 << 16)
+// "p cnf " followed by two numbers of up to 20 digits
+#define header_size 48
+
+DimacsWriter::DimacsWriter(const std::string& path)
+    : buffer(buffer_size), used(0), n_clauses(0), n_vars(0), n_bytes(0)
+{
+    file = std::fopen(path.c_str(), "w");
+    if(file == nullptr)  return;
+
+    // placeholder, rewritten by close
+    std::string header(header_size - 1, ' ');
+    header += '\n';
+    std::fwrite(header.data(), 1, header.size(), file);
+    n_bytes += header.size();
+}
+
+DimacsWriter::~DimacsWriter()
+{
+    close();
+}
+
+void DimacsWriter::flush()
+{
+    std::fwrite(buffer.data(), 1, used, file);
+    n_bytes += used;
+    used = 0;
+}
+
+void DimacsWriter::add(int lit)
+{
+    if(file == nullptr) return;
+
+    // the longest literal takes 11 characters plus the separator
+    if(used + 16 > buffer.size())
+        flush();
+
+    char* out = buffer.data() + used;
+    if(lit == 0){
+        out[0] = '0';
+        out[1] = '\n';
+        used += 2;
+        n_clauses++;
+        return;
+    }
+
+    unsigned value;
+    if(lit < 0){
+        *out++ = '-';
+        value = -(unsigned) lit;
+    }
+    else{
+        value = lit;
+    }
+    if((int) value > n_vars)    n_vars = value;
+
+    char digits[12];
+    int n = 0;
+    do{
+        digits[n++] = (char) ('0' + value % 10);
+        value /= 10;
+    } while(value > 0);
+    while(n > 0)
+        *out++ = digits[--n];
+    *out++ = ' ';
+
+    used = out - buffer.data();
+}
+
+void DimacsWriter::close()
+{
+    if(file == nullptr) return;
+
+    flush();
+    std::fseek(file, 0, SEEK_SET);
+    std::fprintf(file, "p cnf %d %lld", n_vars, n_clauses);
+    std::fclose(file);
+    file = nullptr;
+}
@@ -0,0 +1,59 @@
+//
+// Created by:
+//    Cauim de S. Lima - cauimsouza@gmail.com
+//    Victor Hugo Vianna Silva - victor.vianna10@gmail.com
+//
+
+#ifndef RIKUDOSOLVER_DIMACS_WRITER_H
+#define RIKUDOSOLVER_DIMACS_WRITER_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "sat_solver.h"
+
+/**
+ * @brief Streams clauses to a DIMACS file
+ * @details Literals are formatted by hand into a fixed size buffer which is
+ * flushed with fwrite, so memory use does not depend on the size of the formula.
+ * The header is written with room for any count and filled in by close, once the
+ * number of variables and clauses is known.
+ */
+class DimacsWriter : public ClauseSink
+{
+private:
+    FILE* file;
+    std::vector<char> buffer;
+    size_t used;
+    long long n_clauses;
+    int n_vars;
+    long long n_bytes;
+
+    void flush();
+
+public:
+    /**
+     * @param path file where the formula is written
+     */
+    explicit DimacsWriter(const std::string& path);
+    ~DimacsWriter();
+
+    /**
+     * @return false if the file could not be opened
+     */
+    bool is_open() const { return file != nullptr; }
+
+    void add(int lit);
+
+    /**
+     * @return number of bytes written to the file so far, header included
+     */
+    long long bytes() const { return n_bytes; }
+
+    /**
+     * @brief Writes the header and closes the file
+     */
+    void close();
+};
+
+#endif //RIKUDOSOLVER_DIMACS_WRITER_H
@@ -0,0 +1,179 @@
+//
+// Created by:
+//    Cauim de S. Lima - cauimsouza@gmail.com
+//    Victor Hugo Vianna Silva - victor.vianna10@gmail.com
+//
+
+#include "endpoint_filter.h"
+#include <algorithm>
+
+
+EndpointFilter::EndpointFilter(const std::vector< std::vector<int> >& adj_list)
+    : n_vertices(adj_list.size()), symmetric(true), possible(n_vertices > 0),
+      inner(adj_list.size(), false)
+{
+    neighbors.assign(n_vertices, std::vector<int>());
+    for(int u = 0; u < n_vertices; u++){
+        for(int v : adj_list[u])
+            if(v != u)  neighbors[u].push_back(v);
+        std::sort(neighbors[u].begin(), neighbors[u].end());
+        neighbors[u].erase(std::unique(neighbors[u].begin(), neighbors[u].end()), neighbors[u].end());
+    }
+    for(int u = 0; u < n_vertices; u++)
+        for(int v : neighbors[u])
+            if(!std::binary_search(neighbors[v].begin(), neighbors[v].end(), u))
+                symmetric = false;
+
+    if(n_vertices <= 1) return;
+
+    if(!symmetric){
+        std::vector<int> in_degree(n_vertices, 0);
+        for(int u = 0; u < n_vertices; u++)
+            for(int v : neighbors[u])
+                in_degree[v]++;
+        for(int v = 0; v < n_vertices; v++){
+            if(in_degree[v] == 0)           forced_source.push_back(v);
+            if(neighbors[v].empty())        forced_target.push_back(v);
+        }
+        if(forced_source.size() > 1 || forced_target.size() > 1)
+            possible = false;
+        return;
+    }
+
+    check_connectivity();
+    if(possible)    check_cut_vertices();
+    if(possible)    check_independent_sets();
+}
+
+void EndpointFilter::check_connectivity()
+{
+    std::vector<bool> seen(n_vertices, false);
+    std::vector<int> bfs(1, 0);
+    seen[0] = true;
+    for(int i = 0; i < (int) bfs.size(); i++)
+        for(int w : neighbors[bfs[i]])
+            if(!seen[w]){
+                seen[w] = true;
+                bfs.push_back(w);
+            }
+    if((int) bfs.size() < n_vertices){
+        possible = false;
+        return;
+    }
+
+    for(int v = 0; v < n_vertices; v++)
+        if(neighbors[v].size() == 1)    forced.push_back(v);
+    if(forced.size() > 2)   possible = false;
+}
+
+void EndpointFilter::check_cut_vertices()
+{
+    std::vector<int> component(n_vertices);
+    std::vector<int> bfs;
+    for(int cut = 0; cut < n_vertices && possible; cut++){
+        // components of the graph without cut
+        std::fill(component.begin(), component.end(), -1);
+        int n_components = 0;
+        for(int v = 0; v < n_vertices; v++){
+            if(v == cut || component[v] != -1)    continue;
+            component[v] = n_components;
+            bfs.assign(1, v);
+            for(int i = 0; i < (int) bfs.size(); i++)
+                for(int w : neighbors[bfs[i]])
+                    if(w != cut && component[w] == -1){
+                        component[w] = n_components;
+                        bfs.push_back(w);
+                    }
+            n_components++;
+        }
+
+        if(n_components > 2){
+            possible = false;
+        }
+        else if(n_components == 2){
+            inner[cut] = true;
+            sides.push_back(component);
+        }
+    }
+}
+
+void EndpointFilter::check_independent_sets()
+{
+    // greedy colouring in breadth first order, which two-colours bipartite graphs and
+    // uses three colours on most hexagon boards
+    std::vector<int> colour(n_vertices, -1);
+    std::vector<int> order(1, 0);
+    std::vector<bool> queued(n_vertices, false);
+    queued[0] = true;
+    for(int i = 0; i < (int) order.size(); i++)
+        for(int w : neighbors[order[i]])
+            if(!queued[w]){
+                queued[w] = true;
+                order.push_back(w);
+            }
+
+    int n_colours = 0;
+    std::vector<bool> used;
+    for(int v : order){
+        used.assign(n_colours + 1, false);
+        for(int w : neighbors[v])
+            if(colour[w] != -1) used[colour[w]] = true;
+        colour[v] = std::find(used.begin(), used.end(), false) - used.begin();
+        n_colours = std::max(n_colours, colour[v] + 1);
+    }
+
+    for(int c = 0; c < n_colours; c++){
+        // the class grown into a maximal independent set
+        std::vector<bool> in_set(n_vertices, false);
+        int size = 0;
+        for(int v = 0; v < n_vertices; v++)
+            if(colour[v] == c){
+                in_set[v] = true;
+                size++;
+            }
+        for(int v = 0; v < n_vertices; v++){
+            if(in_set[v])   continue;
+            bool free = true;
+            for(int w : neighbors[v])
+                if(in_set[w])   free = false;
+            if(free){
+                in_set[v] = true;
+                size++;
+            }
+        }
+
+        int need = 2 * size - n_vertices + 1;
+        if(need > 2){
+            possible = false;
+            return;
+        }
+        if(need > 0){
+            independent.push_back(in_set);
+            needed.push_back(need);
+        }
+    }
+}
+
+bool EndpointFilter::may_join(int source, int target) const
+{
+    if(!possible)   return false;
+    if(n_vertices == 1) return source == target;
+    if(source == target)    return false;
+
+    for(int v : forced)
+        if(v != source && v != target)  return false;
+    for(int v : forced_source)
+        if(v != source) return false;
+    for(int v : forced_target)
+        if(v != target) return false;
+
+    if(inner[source] || inner[target])  return false;
+    for(auto& side : sides)
+        if(side[source] == side[target])    return false;
+
+    for(int k = 0; k < (int) independent.size(); k++)
+        if(independent[k][source] + independent[k][target] < needed[k])
+            return false;
+
+    return true;
+}
@@ -0,0 +1,88 @@
+//
+// Created by:
+//    Cauim de S. Lima - cauimsouza@gmail.com
+//    Victor Hugo Vianna Silva - victor.vianna10@gmail.com
+//
+
+#ifndef RIKUDOSOLVER_ENDPOINT_FILTER_H
+#define RIKUDOSOLVER_ENDPOINT_FILTER_H
+
+#include <vector>
+
+/**
+ * @brief Rules telling, without any search, that no hamiltonian path joins two vertices
+ * @details On undirected graphs
+ * - a disconnected graph, or one with an isolated vertex, has no hamiltonian path,
+ * - a vertex of degree one is an endpoint, so there may be at most two of them,
+ * - removing an inner vertex of the path leaves at most two components: a cut vertex
+ * leaving three or more rules out every pair, one leaving two is not an endpoint and
+ * the endpoints lie on different sides of it,
+ * - an independent set I of a path of n vertices with e endpoints in I has at most
+ * (n - 1 + e) / 2 vertices. The sets tried are the classes of a colouring of the graph
+ * (the two sides of a bipartite graph, or the three classes of a hexagon board),
+ * each one grown into a maximal independent set.
+ * On directed graphs a vertex without incoming (outgoing) edges is the source (the target).
+ */
+class EndpointFilter
+{
+private:
+    int n_vertices;
+    bool symmetric;
+
+    /**
+     * distinct neighbors of every vertex, self-loops excluded
+     */
+    std::vector< std::vector<int> > neighbors;
+
+    /**
+     * false if no pair can be joined
+     */
+    bool possible;
+
+    /**
+     * vertices that must be an endpoint, that cannot be one, that must be the source
+     * and that must be the target
+     */
+    std::vector<int> forced;
+    std::vector<bool> inner;
+    std::vector<int> forced_source;
+    std::vector<int> forced_target;
+
+    /**
+     * for every cut vertex leaving two components, the component of each vertex, the
+     * endpoints must be in different ones
+     */
+    std::vector< std::vector<int> > sides;
+
+    /**
+     * independent sets and the number of endpoints each one must hold
+     */
+    std::vector< std::vector<bool> > independent;
+    std::vector<int> needed;
+
+    void check_connectivity();
+    void check_cut_vertices();
+    void check_independent_sets();
+
+public:
+    /**
+     * @param adj_list adjacence list of the graph
+     */
+    explicit EndpointFilter(const std::vector< std::vector<int> >& adj_list);
+
+    /**
+     * @return true if every edge of the graph goes both ways
+     */
+    bool is_symmetric() const { return symmetric; }
+
+    /**
+     * @brief Applies the rules to a pair of endpoints
+     *
+     * @param source origin of the path
+     * @param target destination of the path
+     * @return false if no hamiltonian path goes from source to target
+     */
+    bool may_join(int source, int target) const;
+};
+
+#endif //RIKUDOSOLVER_ENDPOINT_FILTER_H
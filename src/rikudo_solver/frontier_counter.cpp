@@ -0,0 +1,277 @@
+//
+// Created by:
+//    Cauim de S. Lima - cauimsouza@gmail.com
+//    Victor Hugo Vianna Silva - victor.vianna10@gmail.com
+//
+
+#include "frontier_counter.h"
+#include <algorithm>
+#include <climits>
+#include <unordered_map>
+
+// values of a frontier vertex in a state, a fragment end stores its mate + 1
+#define no_edge 0
+#define complete -1
+// number of start vertices tried when looking for a vertex order
+#define order_trials 64
+
+
+namespace
+{
+    struct StateHash
+    {
+        size_t operator()(const std::vector<int>& state) const
+        {
+            size_t h = 14695981039346656037ull;
+            for(int x : state){
+                h ^= (size_t) (unsigned) x;
+                h *= 1099511628211ull;
+            }
+            return h;
+        }
+    };
+
+    typedef std::unordered_map<std::vector<int>, unsigned long long, StateHash> StateMap;
+
+    void add_saturated(unsigned long long& a, unsigned long long b)
+    {
+        const unsigned long long max = LLONG_MAX;
+        a = a > max - b ? max : a + b;
+    }
+
+    // breadth first order of the vertices starting from start, then from the
+    // vertices of other components
+    std::vector<int> bfs_order(const std::vector< std::vector<int> >& adj_list, int start)
+    {
+        int n = adj_list.size();
+        std::vector<int> order;
+        std::vector<bool> seen(n, false);
+        for(int root = start, k = 0; k < n; root = (root + 1) % n, k++){
+            if(seen[root])  continue;
+            seen[root] = true;
+            order.push_back(root);
+            for(int i = order.size() - 1; i < (int) order.size(); i++)
+                for(int w : adj_list[order[i]])
+                    if(!seen[w]){
+                        seen[w] = true;
+                        order.push_back(w);
+                    }
+        }
+        return order;
+    }
+}
+
+
+FrontierCounter::FrontierCounter(const std::vector< std::vector<int> >& adj_list,
+                                 long long max_states)
+    : n_vertices(adj_list.size()), symmetric(true), width(0), max_states(max_states)
+{
+    std::vector< std::vector<int> > sorted(adj_list);
+    for(auto& neighbors : sorted)
+        std::sort(neighbors.begin(), neighbors.end());
+
+    std::vector< std::pair<int,int> > undirected;
+    for(int u = 0; u < n_vertices; u++)
+        for(int v : sorted[u]){
+            if(!std::binary_search(sorted[v].begin(), sorted[v].end(), u))
+                symmetric = false;
+            if(u < v)   undirected.push_back(std::make_pair(u, v));
+        }
+    undirected.erase(std::unique(undirected.begin(), undirected.end()), undirected.end());
+
+    // the numbering of the vertices, or a breadth first order, whichever has the
+    // narrowest frontier
+    std::vector<int> best(n_vertices);
+    for(int v = 0; v < n_vertices; v++)
+        best[v] = v;
+    int best_width = frontier_width(best, undirected);
+
+    int step = std::max(1, n_vertices / order_trials);
+    for(int start = 0; start < n_vertices; start += step){
+        std::vector<int> order = bfs_order(sorted, start);
+        int w = frontier_width(order, undirected);
+        if(w < best_width){
+            best_width = w;
+            best.swap(order);
+        }
+    }
+
+    set_order(best, undirected);
+}
+
+// sorts the edges by the positions of their ends in the order
+void FrontierCounter::set_order(const std::vector<int>& order,
+                                const std::vector< std::pair<int,int> >& undirected)
+{
+    std::vector<int> pos(n_vertices);
+    for(int i = 0; i < n_vertices; i++)
+        pos[order[i]] = i;
+
+    edges = undirected;
+    for(auto& e : edges)
+        if(pos[e.first] > pos[e.second])    std::swap(e.first, e.second);
+    std::sort(edges.begin(), edges.end(), [&pos](const std::pair<int,int>& a, const std::pair<int,int>& b){
+        return std::make_pair(pos[a.first], pos[a.second]) < std::make_pair(pos[b.first], pos[b.second]);
+    });
+
+    first_edge.assign(n_vertices, -1);
+    last_edge.assign(n_vertices, -1);
+    for(int i = 0; i < (int) edges.size(); i++){
+        for(int w : {edges[i].first, edges[i].second}){
+            if(first_edge[w] == -1) first_edge[w] = i;
+            last_edge[w] = i;
+        }
+    }
+
+    int active = 0;
+    width = 0;
+    for(int i = 0; i < (int) edges.size(); i++){
+        for(int w : {edges[i].first, edges[i].second})
+            if(first_edge[w] == i)  active++;
+        width = std::max(width, active);
+        for(int w : {edges[i].first, edges[i].second})
+            if(last_edge[w] == i)   active--;
+    }
+}
+
+int FrontierCounter::frontier_width(const std::vector<int>& order,
+                                    const std::vector< std::pair<int,int> >& undirected)
+{
+    set_order(order, undirected);
+    return width;
+}
+
+int FrontierCounter::get_width() const
+{
+    return width;
+}
+
+long long FrontierCounter::count(int source, int last,
+                                 const std::vector< std::pair<int,int> >& map,
+                                 const std::vector< std::pair<int,int> >& diamonds)
+{
+    int n = n_vertices;
+    if(n == 0 || source < 0 || source >= n || last < 0 || last >= n)
+        return 0;
+    for(auto ith_vertex : map)
+        if(ith_vertex.first < 0 || ith_vertex.first >= n)   return 0;
+    if(n == 1){
+        for(auto ith_vertex : map)
+            if(ith_vertex.second != source) return 0;
+        return source == last && diamonds.empty() ? 1 : 0;
+    }
+    if(!symmetric)      return COUNT_UNKNOWN;
+    if(source == last)  return 0;
+
+    // every constraint becomes an edge forced into the path
+    std::vector< std::pair<int,int> > forced;
+    for(auto ith_vertex : map){
+        int ith = ith_vertex.first;
+        int v = ith_vertex.second;
+        if(ith == 0 || ith == n - 1){
+            if(v != (ith == 0 ? source : last)) return 0;
+            continue;
+        }
+        if(v == source || v == last)    return 0;
+        if(ith == 1)            forced.push_back(std::make_pair(source, v));
+        else if(ith == n - 2)   forced.push_back(std::make_pair(v, last));
+        else                    return COUNT_UNKNOWN;
+    }
+    forced.insert(forced.end(), diamonds.begin(), diamonds.end());
+
+    std::vector<bool> must_use(edges.size(), false);
+    int last_forced = -1;
+    for(auto u_v : forced){
+        auto it = std::find_if(edges.begin(), edges.end(), [u_v](const std::pair<int,int>& e){
+            return (e.first == u_v.first && e.second == u_v.second) ||
+                   (e.first == u_v.second && e.second == u_v.first);
+        });
+        if(it == edges.end())   return 0;
+        int i = it - edges.begin();
+        must_use[i] = true;
+        last_forced = std::max(last_forced, i);
+    }
+
+    int all_entered = -1;
+    for(int v = 0; v < n; v++){
+        if(first_edge[v] == -1) return 0;
+        all_entered = std::max(all_entered, first_edge[v]);
+    }
+
+    // a vertex keeps its slot of the state while it is in the frontier
+    std::vector<int> slot(n, -1);
+    std::vector<bool> occupied(width, false);
+
+    unsigned long long n_paths = 0;
+    StateMap states, next;
+    states[std::vector<int>(width, no_edge)] = 1;
+
+    for(int i = 0; i < (int) edges.size() && !states.empty(); i++){
+        int u = edges[i].first;
+        int v = edges[i].second;
+        for(int w : {u, v}){
+            if(first_edge[w] != i)  continue;
+            slot[w] = std::find(occupied.begin(), occupied.end(), false) - occupied.begin();
+            occupied[slot[w]] = true;
+        }
+        int su = slot[u];
+        int sv = slot[v];
+
+        next.clear();
+        for(auto& state_count : states){
+            const std::vector<int>& state = state_count.first;
+            unsigned long long cnt = state_count.second;
+
+            // the edge is not in the path
+            if(!must_use[i])    add_saturated(next[state], cnt);
+
+            // the edge is in the path
+            if(state[su] == complete || state[sv] == complete)  continue;
+            int ou = state[su] == no_edge ? u : state[su] - 1;
+            int ov = state[sv] == no_edge ? v : state[sv] - 1;
+            if(ou == v) continue; // it would close a cycle
+
+            std::vector<int> joined(state);
+            for(int w : {u, v}){
+                int& value = joined[slot[w]];
+                value = (value == no_edge && w != source && w != last) ? no_edge : complete;
+            }
+            bool ou_end = ou != source && ou != last;
+            bool ov_end = ov != source && ov != last;
+            if(ou_end)  joined[slot[ou]] = ov + 1;
+            if(ov_end)  joined[slot[ov]] = ou + 1;
+
+            if(!ou_end && !ov_end){
+                // the fragment goes from source to last, it must be the whole path
+                if(i < all_entered || i < last_forced)  continue;
+                bool whole = true;
+                for(int k = 0; k < width; k++)
+                    if(occupied[k] && joined[k] != complete)    whole = false;
+                if(whole)   add_saturated(n_paths, cnt);
+                continue;
+            }
+
+            add_saturated(next[joined], cnt);
+        }
+
+        // the vertices leaving the frontier must have all their edges
+        states.clear();
+        for(auto& state_count : next){
+            std::vector<int> state(state_count.first);
+            bool ok = true;
+            for(int w : {u, v}){
+                if(last_edge[w] != i)   continue;
+                if(state[slot[w]] != complete)  ok = false;
+                state[slot[w]] = no_edge;
+            }
+            if(ok)  add_saturated(states[state], state_count.second);
+        }
+        for(int w : {u, v})
+            if(last_edge[w] == i)   occupied[slot[w]] = false;
+
+        if((long long) states.size() > max_states)
+            return COUNT_UNKNOWN;
+    }
+
+    return n_paths;
+}
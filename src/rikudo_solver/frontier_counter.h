@@ -0,0 +1,98 @@
+//
+// Created by:
+//    Cauim de S. Lima - cauimsouza@gmail.com
+//    Victor Hugo Vianna Silva - victor.vianna10@gmail.com
+//
+
+#ifndef RIKUDOSOLVER_FRONTIER_COUNTER_H
+#define RIKUDOSOLVER_FRONTIER_COUNTER_H
+
+#include <utility>
+#include <vector>
+
+/**
+ * Returned by FrontierCounter::count when the question cannot be answered
+ */
+const long long COUNT_UNKNOWN = -1;
+
+/**
+ * @brief Counts hamiltonian paths between two vertices with a frontier based
+ * dynamic program (simpath)
+ * @details The edges are processed one by one in an order of the vertices that keeps
+ * the frontier (the vertices with both processed and unprocessed edges) small. A state
+ * records, for every frontier vertex, whether it has no edge yet, is complete or is the
+ * end of a fragment of path, and in this case the other end of the fragment. The states
+ * reached by the same frontier are merged with the sum of their counts, so the time is
+ * exponential only in the width of the frontier, which is small on planar boards.
+ *
+ * Diamonds are edges forced into the path. The map can only be expressed for the
+ * instants 0, 1, n-2 and n-1 (edges forced at the endpoints), other instants make the
+ * count unknown.
+ */
+class FrontierCounter
+{
+private:
+    int n_vertices;
+
+    /**
+     * false if some edge goes only one way, the counter only handles undirected graphs
+     */
+    bool symmetric;
+
+    /**
+     * edges with both ends in increasing position of the vertex order, sorted
+     */
+    std::vector< std::pair<int,int> > edges;
+
+    /**
+     * index of the first and the last edge of every vertex, or -1
+     */
+    std::vector<int> first_edge;
+    std::vector<int> last_edge;
+
+    /**
+     * maximum number of vertices in the frontier
+     */
+    int width;
+
+    /**
+     * maximum number of states kept for a frontier before the count is given up
+     */
+    long long max_states;
+
+    int frontier_width(const std::vector<int>& order,
+                       const std::vector< std::pair<int,int> >& undirected);
+    void set_order(const std::vector<int>& order,
+                   const std::vector< std::pair<int,int> >& undirected);
+
+public:
+    /**
+     * @param adj_list adjacence list of the graph
+     * @param max_states limit on the number of states of a frontier
+     */
+    explicit FrontierCounter(const std::vector< std::vector<int> >& adj_list,
+                             long long max_states = 4000000);
+
+    /**
+     * @brief Counts the hamiltonian paths from source to last respecting the constraints
+     *
+     * @param source origin of the paths
+     * @param last destination of the paths
+     * @param map list of pairs of integers of the form (i, v) representing
+     * the condition "vertex v must be visited at instant i"
+     * @param diamonds list of diamonds in the form of a list of pairs of integers of the form (u, v) representing
+     * the condition "vertex v and vertex u must be visited consecutively, in any order"
+     * @return number of paths, saturated at LLONG_MAX, or COUNT_UNKNOWN if the graph is
+     * directed, the map fixes an instant other than 0, 1, n-2 or n-1, or there are too many states
+     */
+    long long count(int source, int last,
+                    const std::vector< std::pair<int,int> >& map,
+                    const std::vector< std::pair<int,int> >& diamonds);
+
+    /**
+     * @return maximum number of vertices in the frontier of the chosen vertex order
+     */
+    int get_width() const;
+};
+
+#endif //RIKUDOSOLVER_FRONTIER_COUNTER_H
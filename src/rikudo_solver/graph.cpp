@@ -5,6 +5,8 @@
 //
 
 #include "graph.h"
+#include "cdcl_solver.h"
+#include "endpoint_filter.h"
 #include <climits>
 #include <utility>
 #include <fstream>
@@ -16,6 +18,12 @@
 #include <sstream>
 #include <random>
 #include <algorithm>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <cstdlib>
 #include <libgen.h>
 #include <unistd.h>
 
@@ -23,8 +31,8 @@
 
 #define sat_input "sat_input.txt"
 #define sat_output "sat_output.txt"
-#define sat_aux_input "sat_aux_input.txt"
 #define sat_solver "cryptominisat"
+#define default_split_depth 8
 
 
 int Graph::encode(int ith, int vertex, bool offset)
@@ -40,79 +48,42 @@ void Graph::decode(int var, int &i, int &v){
     v = var % n_vertices;
 }
 
-bool Graph::backtracking(int v,
-                         int n,
-                         int last,
-                         bool count)
+Graph::Graph(std::istream &file)
 {
-    visited[v] = true;
-    path[n] = v;
-
-    if (n == n_vertices - 1)
-    {
-        visited[v] = false;
-        if(v == last){
-            paths.push_back(path);
-            return true;
-        }
-        
-        return false;
-    }
-
-    for (int neighbor : adj_list[v])
-    {
-        if (!visited[neighbor] && backtracking(neighbor, n + 1, last, count) && !count)
-            return true;
-    }
-
-    visited[v] = false;
-    return false;
-}
-
-bool Graph::valid(const std::vector<int> &candidate,
-                  const std::vector< std::pair<int,int> >& map,
-                  const std::vector< std::pair<int,int> >& diamonds)
-{    
-    for(auto pair : map){
-        int ith = pair.first;
-        int vertex = pair.second;
-        if(candidate[ith] != vertex)    return false;
-    }
-
-    for(auto pair : diamonds){
-        int u = pair.first;
-        int v = pair.second;
-        for(int ith = 0; ith < candidate.size(); ith++)
-            if(candidate[ith] == u){
-                if(ith > 0 && candidate[ith-1] == v)    continue;
-                if(ith < candidate.size() - 1 && candidate[ith+1] == v) continue;
-                return false;
-            }
-    }
-
-    return true;
-}
-
-Graph::Graph(std::ifstream &file)
-{
-    int n_vertices;
+    int n_vertices = 0;
     file >> n_vertices;
 
     if(n_vertices <= 0)
         throw "Number of vertices should be a positive integer.";
 
     this->n_vertices = n_vertices;
+    sat_backend = SatBackend::EMBEDDED;
+    sat_status = SAT_UNKNOWN;
+    n_threads = 1;
+    sat_seed = 0;
+    fixed_shuffle = false;
+    shuffle_seed = 0;
+    terminate = nullptr;
+    use_portfolio = false;
+    minimise = true;
+    n_min_calls = 0;
+    kernelise = true;
+    decompose = true;
+    stats = nullptr;
+    cache = nullptr;
+    split_depth = default_split_depth;
+    n_vars = 0;
+    n_clauses = 0;
     adj_list.assign(static_cast<unsigned long>(n_vertices), std::vector<int>());
 
     while (true)
     {
         int a, b;
-        file >> a;
-        if (a < 0)
+        if (!(file >> a) || a < 0)
             break;
         file >> b;
 
-        if(a >= n_vertices || b < 0 || b >= n_vertices)
+        if(!file || a >= n_vertices || b < 0 || b >= n_vertices)
             throw "Invalid vertex index";
 
         adj_list[a].push_back(b);
@@ -122,6 +93,71 @@ Graph::Graph(std::ifstream &file)
 Graph::Graph(const std::vector< std::vector<int> >& adj_list){
     this->adj_list = adj_list;
     n_vertices = adj_list.size();
+    sat_backend = SatBackend::EMBEDDED;
+    sat_status = SAT_UNKNOWN;
+    n_threads = 1;
+    sat_seed = 0;
+    fixed_shuffle = false;
+    shuffle_seed = 0;
+    terminate = nullptr;
+    use_portfolio = false;
+    minimise = true;
+    n_min_calls = 0;
+    kernelise = true;
+    decompose = true;
+    stats = nullptr;
+    cache = nullptr;
+    split_depth = default_split_depth;
+    n_vars = 0;
+    n_clauses = 0;
+}
+
+void Graph::set_sat_backend(SatBackend backend){
+    sat_backend = backend;
+}
+
+void Graph::set_encoding_options(const EncodingOptions& options){
+    encoding = options;
+}
+
+void Graph::set_external_solver(const std::string& solver_path,
+                                const std::string& input_path,
+                                const std::string& output_path){
+    sat_backend = SatBackend::EXTERNAL;
+    external_solver = solver_path;
+    external_input = input_path;
+    external_output = output_path;
+}
+
+void Graph::set_workspace(const std::string& dir){
+    external_input = dir + "/" + sat_input;
+    external_output = dir + "/" + sat_output;
+}
+
+void Graph::set_sat_seed(unsigned seed){
+    sat_seed = seed;
+}
+
+void Graph::set_shuffle_seed(unsigned seed){
+    fixed_shuffle = true;
+    shuffle_seed = seed;
+}
+
+void Graph::set_terminate(const std::atomic<bool>* flag){
+    terminate = flag;
+    if(solver)      solver->set_terminate(flag);
+    if(searcher)    searcher->set_terminate(flag);
+}
+
+void Graph::set_portfolio(const PortfolioOptions& options){
+    use_portfolio = true;
+    portfolio = options;
+}
+
+void Graph::set_parallelism(int n_threads, int split_depth){
+    this->n_threads = std::max(n_threads, 1);
+    this->split_depth = split_depth;
+    if(pool && pool->size() != this->n_threads)  pool.reset();
 }
 
 int Graph::get_n_vertices(){
@@ -134,139 +170,95 @@ const std::vector< std::vector<int> > Graph::get_adj_list()
 }
 
 // every vertex visited
-void Graph::condition1(std::vector< std::vector<int> >& clauses){
-    std::vector<int> clause;
-
-     // every vertex visited
+void Graph::condition1(ClauseSink& sink){
     for(int i = 0; i < n_vertices; i++){
-        clause.clear();
-        for(int j = 0; j < n_vertices; j++){
-            int id = encode(j, i);
-            clause.push_back(id);
-        }
-        clauses.push_back(clause);
+        for(int j = 0; j < n_vertices; j++)
+            sink.add(encode(j, i));
+        sink.add(0);
     }
 }
 
 // every vertex at most once
-void Graph::condition2(std::vector< std::vector<int> >& clauses){
-    std::vector<int> clause;
+void Graph::condition2(ClauseSink& sink, AmoEncoding amo){
+    std::vector<int> lits;
     for(int i = 0; i < n_vertices; i++){
-        for(int j = 0; j < n_vertices; j++){
-            for(int k = j + 1; k < n_vertices; k++){
-                clause.clear();
-                int id_1 = -encode(j, i);
-                int id_2 = -encode(k, i);
-                clause.push_back(id_1);
-                clause.push_back(id_2);
-                clauses.push_back(clause);                
-            }
-        }
+        lits.clear();
+        for(int j = 0; j < n_vertices; j++)
+            lits.push_back(encode(j, i));
+        at_most_one(amo, lits, n_vars, sink);
     }
 }
 
 // in every instant a vertex
-void Graph::condition3(std::vector< std::vector<int> >& clauses){
-    std::vector<int> clause;
-
+void Graph::condition3(ClauseSink& sink){
     for(int i = 0; i < n_vertices; i++){
-        clause.clear();
-        for(int j = 0; j < n_vertices; j++){
-            int id = encode(i, j);
-            clause.push_back(id);
-        }
-        clauses.push_back(clause);
+        for(int j = 0; j < n_vertices; j++)
+            sink.add(encode(i, j));
+        sink.add(0);
     }
 }
 
 // in every instant at most one vertex
-void Graph::condition4(std::vector< std::vector<int> >& clauses){
-    std::vector<int> clause;
+void Graph::condition4(ClauseSink& sink, AmoEncoding amo){
+    std::vector<int> lits;
     for(int i = 0; i < n_vertices; i++){
-        for(int j = 0; j < n_vertices; j++){
-            for(int k = j+1; k < n_vertices; k++){
-                clause.clear();
-                int id_1 = -encode(i, j);
-                int id_2 = -encode(i, k);
-                clause.push_back(id_1);
-                clause.push_back(id_2);
-                clauses.push_back(clause); 
-            }
-        }
+        lits.clear();
+        for(int j = 0; j < n_vertices; j++)
+            lits.push_back(encode(i, j));
+        at_most_one(amo, lits, n_vars, sink);
     }
 }
 
 // adds clauses so that x_i_j and x_i+1_k => there is an edge from j to k
-void Graph::condition5(std::vector< std::vector<int> >& clauses){
-    std::vector<int> clause;
+void Graph::condition5(ClauseSink& sink){
     for (int ith = 0; ith < n_vertices - 1; ith++)
     {
         for (int vertex = 0; vertex < n_vertices; vertex++)
         {
-            int var_id = encode(ith, vertex);
-            clause.clear();
-            clause.push_back(-var_id);
+            sink.add(-encode(ith, vertex));
             for (int neighbor : adj_list[vertex])
-            {
-                int neighbor_id = encode(ith + 1, neighbor);
-                clause.push_back(neighbor_id);
-            }
-            clauses.push_back(clause);
+                sink.add(encode(ith + 1, neighbor));
+            sink.add(0);
         }
     }
 }
 
 // add map clauses
-void Graph::condition6(std::vector< std::vector<int> >& clauses,
+void Graph::condition6(ClauseSink& sink,
     const std::vector< std::pair<int,int> >& map)
 {
-    std::vector<int> clause;
     for(auto ith_vertex : map){
-        clause.clear();
-        int var_id = encode(ith_vertex.first, ith_vertex.second);
-        clauses.push_back(clause);
+        sink.add(encode(ith_vertex.first, ith_vertex.second));
+        sink.add(0);
     }
 }
 
 // add diamonds clauses
-void Graph::condition7(std::vector< std::vector<int> >& clauses,
+void Graph::condition7(ClauseSink& sink,
     const std::vector< std::pair<int,int> >& diamonds)
 {
-    std::vector<int> clause;
     for(auto vi_vj : diamonds){
         for(int ith = 0; ith < n_vertices; ith++){
-            clause.clear();
-
-            int vi_id = encode(ith, vi_vj.first);
-            clause.push_back(-vi_id);
-            if(ith > 0){
-                int vj_id = encode(ith-1, vi_vj.second);
-                clause.push_back(vj_id);
-            }
-            if(ith < n_vertices-1){
-                int vj_id = encode(ith+1, vi_vj.second);
-                clause.push_back(vj_id);
-            }
-            clauses.push_back(clause);
+            sink.add(-encode(ith, vi_vj.first));
+            if(ith > 0)
+                sink.add(encode(ith-1, vi_vj.second));
+            if(ith < n_vertices-1)
+                sink.add(encode(ith+1, vi_vj.second));
+            sink.add(0);
         }
     }
 }
 
 // transitivity
-void Graph::condition8(std::vector< std::vector<int> >& clauses){
-    std::vector<int> clause;
+void Graph::condition8(ClauseSink& sink){
     for(int i = 0; i < n_vertices; i++){
         for(int j = 0; j < n_vertices; j++){
             for(int k = 0; k < n_vertices; k++){
                 if(i == j || i == k || j == k)    continue;
-                int v1 = -encode(i, j, true);
-                int v2 = -encode(j, k, true);
-                int v3 = encode(i, k, true);
-                clause.clear();
-                clause.push_back(v1);
-                clause.push_back(v2);
-                clause.push_back(v3);
-                clauses.push_back(clause);
+                sink.add(-encode(i, j, true));
+                sink.add(-encode(j, k, true));
+                sink.add(encode(i, k, true));
+                sink.add(0);
             }
         }
     }
@@ -274,169 +266,325 @@ void Graph::condition8(std::vector< std::vector<int> >& clauses){
 
 
 // total order relation
-void Graph::condition9(std::vector< std::vector<int> >& clauses){
-    std::vector<int> clause;
+void Graph::condition9(ClauseSink& sink){
     for(int i = 0; i < n_vertices; i++){
         for(int j = 0; j < n_vertices; j++){
             if(i == j)  continue;
             int v1 = encode(i, j, true);
             int v2 = encode(j, i, true);
-            clause.clear();
-            clause.push_back(v1);
-            clause.push_back(v2);
-            clauses.push_back(clause);
-            clause.clear();
-            clause.push_back(-v1);
-            clause.push_back(-v2);
-            clauses.push_back(clause);
+            sink.add(v1);
+            sink.add(v2);
+            sink.add(0);
+            sink.add(-v1);
+            sink.add(-v2);
+            sink.add(0);
         }
     }
 }
 
 
 // correlation
-void Graph::condition10(std::vector< std::vector<int> >& clauses){
-    std::vector<int> clause;
+void Graph::condition10(ClauseSink& sink){
     for(int t = 0; t < n_vertices - 1; t++){
         for(int u = 0; u < n_vertices; u++){
             for(int v = 0; v < n_vertices; v++){
-                int v1 = -encode(t, u);
-                int v2 = -encode(t+1, v);
-                int v3 = encode(u, v, true);
-                clause.clear();
-                clause.push_back(v1);
-                clause.push_back(v2);
-                clause.push_back(v3);
-                clauses.push_back(clause);
+                sink.add(-encode(t, u));
+                sink.add(-encode(t+1, v));
+                sink.add(encode(u, v, true));
+                sink.add(0);
             }
         }
     }
 }
 
 // first
-void Graph::condition11(std::vector< std::vector<int> >& clauses, int source){
-    std::vector<int> clause;
+void Graph::condition11(ClauseSink& sink, int source){
     for(int i = 0; i < n_vertices; i++){
         if(i == source) continue;
-        int v = encode(source, i, true);
-        clause.clear();
-        clause.push_back(v);
-        clauses.push_back(clause);
+        sink.add(encode(source, i, true));
+        sink.add(0);
     }
 }
 
 // last
-void Graph::condition12(std::vector< std::vector<int> >& clauses, int dest){
-    std::vector<int> clause;
+void Graph::condition12(ClauseSink& sink, int dest){
     for(int i = 0; i < n_vertices; i++){
         if(i == dest) continue;
-        int v = encode(i, dest, true);
-        clause.clear();
-        clause.push_back(v);
-        clauses.push_back(clause);
+        sink.add(encode(i, dest, true));
+        sink.add(0);
     }
 }
 
 // first 2
-void Graph::condition13(std::vector< std::vector<int> >& clauses, int source){
-    std::vector<int> clause;
-    clause.clear();
-    int x = encode(0, source);
-    clause.push_back(x);
-    clauses.push_back(clause);
+void Graph::condition13(ClauseSink& sink, int source){
+    sink.add(encode(0, source));
+    sink.add(0);
 }
 
 // last 2
-void Graph::condition14(std::vector< std::vector<int> >& clauses, int dest){
-    std::vector<int> clause;
-    clause.clear();
-    int x = encode(n_vertices-1, dest);
-    clause.push_back(x);
-    clauses.push_back(clause);
+void Graph::condition14(ClauseSink& sink, int dest){
+    sink.add(encode(n_vertices-1, dest));
+    sink.add(0);
 }
 
+// successor variables: s_u_v is true if v comes right after u in the path
+// every vertex but dest has one successor, every vertex but source one predecessor
+void Graph::condition15(ClauseSink& sink, int source, int dest){
+    std::vector< std::vector<int> > succ(n_vertices), pred(n_vertices);
+    std::vector<int> last_from(n_vertices, -1);
+
+    for(int u = 0; u < n_vertices; u++){
+        for(int v : adj_list[u]){
+            if(u == dest || v == source || last_from[v] == u)   continue;
+            last_from[v] = u; // skips repeated edges
+            int s = new_var();
+            succ[u].push_back(s);
+            pred[v].push_back(s);
+
+            // x_t_u and x_t+1_v <=> s_u_v and x_t_u
+            for(int t = 0; t < n_vertices - 1; t++){
+                sink.add(-encode(t, u));
+                sink.add(-encode(t+1, v));
+                sink.add(s);
+                sink.add(0);
+
+                sink.add(-s);
+                sink.add(-encode(t, u));
+                sink.add(encode(t+1, v));
+                sink.add(0);
+            }
+        }
+    }
 
+    for(int u = 0; u < n_vertices; u++){
+        if(u != dest)   sink.add_clause(succ[u]);
+        if(u != source) sink.add_clause(pred[u]);
+        at_most_one(AmoEncoding::PAIRWISE, succ[u], n_vars, sink);
+        at_most_one(AmoEncoding::PAIRWISE, pred[u], n_vars, sink);
+    }
+}
+
+// symmetry breaking: the automorphisms fixing the endpoints and the map and preserving
+// the diamonds map paths to paths, so the second vertex of the path can be the smallest
+// of its orbit, and the third one the smallest of its orbit under the automorphisms that
+// also fix the second
+void Graph::condition16(ClauseSink& sink, int source, int dest,
+                        const std::vector< std::pair<int,int> >& map,
+                        const std::vector< std::pair<int,int> >& diamonds){
+    if(n_vertices < 3)  return;
+
+    std::vector<int> fixed = {source, dest};
+    for(auto ith_vertex : map)
+        if(ith_vertex.second >= 0 && ith_vertex.second < n_vertices)
+            fixed.push_back(ith_vertex.second);
+    std::vector<Permutation> group = get_symmetry().stabilizer(fixed, diamonds);
+    if(group.empty())   return;
+
+    std::vector<int> smallest = Symmetry::orbits(n_vertices, group);
+    std::vector<bool> seen(n_vertices, false);
+    for(int v : adj_list[source]){
+        if(seen[v]) continue;
+        seen[v] = true;
+        if(smallest[v] != v){
+            sink.add(-encode(1, v));
+            sink.add(0);
+            continue;
+        }
+
+        std::vector<Permutation> fixing_v;
+        for(auto& p : group)
+            if(p[v] == v)   fixing_v.push_back(p);
+        if(fixing_v.empty())    continue;
+
+        std::vector<int> smallest_v = Symmetry::orbits(n_vertices, fixing_v);
+        for(int w : adj_list[v]){
+            if(smallest_v[w] == w)  continue;
+            sink.add(-encode(1, v));
+            sink.add(-encode(2, w));
+            sink.add(0);
+        }
+    }
+}
 
 void Graph::construct_sat(int source, int dest,
                           const std::vector< std::pair<int,int> >& map,
-                          const std::vector< std::pair<int,int> >& diamonds)
+                          const std::vector< std::pair<int,int> >& diamonds,
+                          const EncodingOptions& options)
 {
-    std::vector<int> clause;
-    std::vector< std::vector<int> > clauses;
-
-    condition1(clauses);
-    condition2(clauses);
-    condition3(clauses);
-    condition4(clauses); // useful
-    condition5(clauses);
-    condition6(clauses, map);
-    condition7(clauses, diamonds);
-    condition13(clauses, source); // not useful
-    condition14(clauses, dest); // not useful
+    PhaseTimer timer(stats, "construct_sat");
+
+    // clauses go straight to the solver, without being stored here
+    solver = new_solver();
+    CountingSink sink(*solver);
+
+    // position and order variables come first, auxiliary ones are allocated after them
+    n_vars = 2 * n_vertices * n_vertices;
+
+    // what each family added since the previous one, when stats are on
+    int family_vars = n_vars;
+    long long family_clauses = 0;
+    long long family_literals = 0;
+    auto measure = [&](const char* name){
+        if(!stats)  return;
+        stats->add_family(name, n_vars - family_vars, sink.n_clauses - family_clauses,
+                          sink.n_literals - family_literals);
+        family_vars = n_vars;
+        family_clauses = sink.n_clauses;
+        family_literals = sink.n_literals;
+    };
+
+    condition1(sink);               measure("condition1");
+    condition2(sink, options.amo);  measure("condition2");
+    condition3(sink);               measure("condition3");
+    condition4(sink, options.amo);  measure("condition4"); // useful
+    condition5(sink);               measure("condition5");
+    condition6(sink, map);          measure("condition6");
+    condition7(sink, diamonds);     measure("condition7");
+
+    // the order relation only pins the endpoints when all of it is there
+    // with free endpoints, given later as assumptions, the families naming them are left out
+    unsigned families = options.families;
+    bool free_ends = source < 0 || dest < 0;
+    if(free_ends)
+        families &= ~(FIRST_POSITION | LAST_POSITION | FIRST_ORDER | LAST_ORDER | SUCCESSOR | SYMMETRY_BREAKING);
+    unsigned first_order = TRANSITIVITY | TOTAL_ORDER | CORRELATION | FIRST_ORDER;
+    unsigned last_order = TRANSITIVITY | TOTAL_ORDER | CORRELATION | LAST_ORDER;
+    if(!free_ends && ((families & FIRST_POSITION) || (families & first_order) != first_order)){
+        condition13(sink, source);
+        measure("condition13");
+    }
+    if(!free_ends && ((families & LAST_POSITION) || (families & last_order) != last_order)){
+        condition14(sink, dest);
+        measure("condition14");
+    }
+
     // order relation 
-    
-    condition8(clauses);
-    condition9(clauses);
-    condition10(clauses);
-    condition11(clauses, source);
-    condition12(clauses, dest);
-    
-    
+    if(families & TRANSITIVITY){ condition8(sink);          measure("condition8"); }
+    if(families & TOTAL_ORDER){  condition9(sink);          measure("condition9"); }
+    if(families & CORRELATION){  condition10(sink);         measure("condition10"); }
+    if(families & FIRST_ORDER){  condition11(sink, source); measure("condition11"); }
+    if(families & LAST_ORDER){   condition12(sink, dest);   measure("condition12"); }
+
+    if(families & SUCCESSOR){    condition15(sink, source, dest); measure("condition15"); }
+
+    if(families & SYMMETRY_BREAKING){
+        condition16(sink, source, dest, map, diamonds);
+        measure("condition16");
+    }
 
-    write_sat(clauses);
+    n_clauses = sink.n_clauses;
+    if(stats){
+        stats->add("formulas", 1);
+        stats->add("vars", n_vars);
+        stats->add("clauses", n_clauses);
+    }
 }
 
-void Graph::write_sat(std::vector<std::vector<int> > &clauses){
-    std::ofstream ofs(get_path(sat_input));
+Symmetry& Graph::get_symmetry(){
+    if(!symmetry){
+        PhaseTimer timer(stats, "symmetry");
+        symmetry.reset(new Symmetry(adj_list));
+        if(stats)   stats->add("automorphisms", symmetry->get_automorphisms().size());
+    }
+    return *symmetry;
+}
 
-    ofs << "p cnf " << n_vertices*n_vertices*2 << " " << (int) clauses.size() << "\n";
-    for(auto c : clauses){
-        bool first = true;
-        for(auto v : c){
-            if(!first)  ofs << " ";
-            ofs << v;
-            first = false;
-        }
-        ofs << " 0\n";
+bool Graph::cache_find(const std::string& key, std::string& value){
+    if(!cache)  return false;
+    bool found = cache->find(key, value);
+    if(stats)   stats->add(found ? "cache_hits" : "cache_misses", 1);
+    return found;
+}
+
+// a path written as its vertices separated by spaces, empty when there is none
+static std::string path_to_string(const std::vector< std::vector<int> >& paths){
+    std::ostringstream out;
+    if(!paths.empty())
+        for(int v : paths[0])
+            out << v << " ";
+    return out.str();
+}
+
+static std::vector< std::vector<int> > string_to_path(const std::string& value){
+    std::istringstream in(value);
+    std::vector<int> found;
+    int v;
+    while(in >> v)
+        found.push_back(v);
+    std::vector< std::vector<int> > paths;
+    if(!found.empty())  paths.push_back(found);
+    return paths;
+}
+
+EncodingOptions Graph::exact_encoding(){
+    EncodingOptions options = encoding;
+    options.families &= ~SYMMETRY_BREAKING;
+    return options;
+}
+
+std::vector<int> Graph::cycle_sources(int last,
+                                      const std::vector< std::pair<int,int> >& map,
+                                      const std::vector< std::pair<int,int> >& diamonds,
+                                      std::vector< std::vector<Permutation> >& images){
+    std::vector<int> fixed(1, last);
+    for(auto ith_vertex : map)
+        if(ith_vertex.second >= 0 && ith_vertex.second < n_vertices)
+            fixed.push_back(ith_vertex.second);
+    std::vector<Permutation> group = get_symmetry().stabilizer(fixed, diamonds);
+    std::vector<int> smallest = Symmetry::orbits(n_vertices, group);
+
+    std::vector<int> sources;
+    images.clear();
+    for(int source : adj_list[last]){
+        if(smallest[source] != source)  continue;
+        if(std::find(sources.begin(), sources.end(), source) != sources.end())  continue;
+        sources.push_back(source);
+
+        images.push_back(std::vector<Permutation>());
+        std::vector<Permutation> to = Symmetry::transversal(n_vertices, source, group);
+        for(int u = 0; u < n_vertices; u++)
+            if(u != source && !to[u].empty())   images.back().push_back(to[u]);
     }
+    return sources;
+}
 
-    ofs.close();
+std::unique_ptr<SatSolver> Graph::new_solver(){
+    std::unique_ptr<SatSolver> solver;
+    if(sat_backend == SatBackend::EXTERNAL){
+        std::string bin_dir = get_path("");
+        std::string sat_path = bin_dir + "../lib/" + sat_solver;
+        solver.reset(new ExternalSatSolver(
+            external_solver.empty() ? sat_path : external_solver,
+            external_input.empty() ? get_path(sat_input) : external_input,
+            external_output.empty() ? get_path(sat_output) : external_output));
+    }
+    else{
+        solver.reset(new CdclSolver(sat_seed));
+    }
 
-    std::cout << "sat formula written\n";
+    solver->set_terminate(terminate);
+    solver->set_stats(stats);
+    return solver;
 }
 
 std::vector<int>& Graph::read_sol()
 {
+    PhaseTimer timer(stats, "read_sol");
     path.assign(n_vertices, -1);
 
-    std::ifstream myfile;
-    myfile.open(get_path(sat_output));
-
-    std::string line;
-
-    while(getline(myfile, line)){
-        std::istringstream iss(line);
-
-        std::string type;
-        iss >> type;
+    if(sat_status != SAT_SATISFIABLE){
+        path.clear();
+        return path;
+    }
 
-        if(type == "v"){
-            int val;
-            while(iss >> val){
-                if(val > 0 && val <= n_vertices * n_vertices){
-                    int i, j;
-                    decode(val, i, j);
-                    path[i] = j;
-                }
-            }
+    for(int val = 1; val <= n_vertices * n_vertices; val++){
+        if(solver->val(val) > 0){
+            int i, j;
+            decode(val, i, j);
+            path[i] = j;
         }
     }
 
-
-    myfile.close();
-
-    std::cout << "sat file read\n";
-    
     for(int i = 0; i < n_vertices; i++){
         if(path[i] == -1) {
             path.clear();
@@ -454,42 +602,106 @@ Graph::ham_path_sat(int first,
                     const std::vector< std::pair<int,int> >& map,
                     const std::vector< std::pair<int,int> >& diamonds)
 {
+    if(solve_on_kernel(first, last, true, count, map, diamonds))
+        return paths;
+    if(!count && map.empty() && diamonds.empty() && solve_decomposed(first, last, true))
+        return paths;
+
     paths.clear();
-    construct_sat(first, last, map, diamonds);
+    if(count){
+        enumerate_sat(first, last, [this](const std::vector<int>& p){
+            paths.push_back(p);
+            return true;
+        }, map, diamonds);
+        return paths;
+    }
+
+    construct_sat(first, last, map, diamonds, encoding);
     solve_sat();
     path = read_sol();
+    if(!path.empty())   paths.push_back(path);
+    return paths;
+}
 
-    while(!path.empty()){
-        paths.push_back(path);
-        
-        if(!count)  break;
-
-        int nvars, nclauses;
-        auto ban = create_ban(path);
-        extend_sat(ban, nvars, nclauses);
-        recopy(nvars, nclauses);
-        solve_sat();
+long long Graph::enumerate_sat(int first,
+                               int last,
+                               const PathVisitor& visitor,
+                               const std::vector< std::pair<int,int> >& map,
+                               const std::vector< std::pair<int,int> >& diamonds)
+{
+    construct_sat(first, last, map, diamonds, exact_encoding());
+    long long n_paths = 0;
+    while(solve_sat()){
         path = read_sol();
+        if(path.empty())    break;
+        n_paths++;
+
+        // the solver stays alive, only the new clause is added
+        solver->add_clause(create_ban(path));
+        if(visitor && !visitor(path))   break;
     }
-    
-    return paths;
+    return n_paths;
 }
 
-void Graph::solve_sat(){
-    char buffer[1024];  
-    int buffer_size = 1024;
-    
-    readlink("/proc/self/exe", buffer, buffer_size);
-    char *path_s = dirname(buffer);
-    char *parpath_s = dirname(path_s);
-    std::string path(path_s);
-    std::string sat_path(std::string(parpath_s) + "/lib/" + sat_solver);
-    std::string inp_path(path + "/bin/" + std::string(sat_input));
-    std::string out_path(path + "/bin/" + std::string(sat_output));
-    std::cout << inp_path << "\n" << out_path << "\n";
+std::unique_ptr<PathIterator> Graph::iterate_paths(int source,
+                                                   int last,
+                                                   bool sat,
+                                                   long long limit,
+                                                   const std::vector< std::pair<int,int> >& map,
+                                                   const std::vector< std::pair<int,int> >& diamonds)
+{
+    // the constraints are copied, the search outlives this call
+    PathProducer search = [this, source, last, sat, map, diamonds](const PathVisitor& visitor){
+        for_each_path(source, last, visitor, sat, map, diamonds);
+    };
+    return std::unique_ptr<PathIterator>(new PathIterator(search, limit));
+}
+
+long long Graph::for_each_path(int source,
+                               int last,
+                               const PathVisitor& visitor,
+                               bool sat,
+                               const std::vector< std::pair<int,int> >& map,
+                               const std::vector< std::pair<int,int> >& diamonds)
+{
+    // paths of the kernel and of the graph correspond one to one
+    Kernel* k = build_kernel(source, last, map, diamonds);
+    if(k && (k->is_infeasible() || !k->is_trivial())){
+        sat_status = SAT_UNSATISFIABLE;
+        if(k->is_infeasible())  return 0;
+        PathVisitor lifted;
+        if(visitor) lifted = [k, &visitor](const std::vector<int>& p){ return visitor(k->lift(p)); };
+        long long n_paths = kernel_graph->for_each_path(k->get_source(), k->get_target(), lifted, sat);
+        sat_status = kernel_graph->sat_status;
+        return n_paths;
+    }
+
+    if(sat) return enumerate_sat(source, last, visitor, map, diamonds);
 
-    std::string cmd = sat_path + " " + inp_path + " > " + out_path; 
-    std::system(cmd.data());
+    PhaseTimer timer(stats, "backtracking");
+    if(!searcher){
+        searcher = PathSearch::create(adj_list);
+        searcher->set_terminate(terminate);
+    }
+    return searcher->search(source, last, map, diamonds, visitor);
+}
+
+bool Graph::solve_sat(){
+    PhaseTimer timer(stats, "solve");
+    sat_status = solver->solve();
+    return sat_status == SAT_SATISFIABLE;
+}
+
+// appends to a list of cycles their images by some automorphisms
+static void add_images(std::vector< std::vector<int> >& cycles, const std::vector<Permutation>& perms){
+    int n_cycles = cycles.size();
+    for(auto& p : perms)
+        for(int c = 0; c < n_cycles; c++){
+            std::vector<int> image(cycles[c].size());
+            for(int i = 0; i < (int) image.size(); i++)
+                image[i] = p[cycles[c][i]];
+            cycles.push_back(image);
+        }
 }
 
 std::vector< std::vector<int> >&
@@ -507,8 +719,11 @@ Graph::ham_cycle_sat(bool count,
     }
     std::vector< std::vector<int> > sol;
 
-    for(int source : adj_list[min_deg_v]){
-        paths = ham_path_sat(source, min_deg_v, count, map, diamonds);
+    std::vector< std::vector<Permutation> > images;
+    std::vector<int> sources = cycle_sources(min_deg_v, map, diamonds, images);
+    for(int k = 0; k < (int) sources.size(); k++){
+        paths = ham_path_sat(sources[k], min_deg_v, count, map, diamonds);
+        if(count)   add_images(paths, images[k]);
         sol.insert(sol.begin(), paths.begin(), paths.end());
         if(!count && !sol.empty())  break;
     }
@@ -524,21 +739,80 @@ std::vector< std::vector<int> >& Graph::ham_path_bt(int source,
                                                      const std::vector< std::pair<int,int> >& map,
                                                      const std::vector< std::pair<int,int> >& diamonds)
 {
+    if(solve_on_kernel(source, last, false, count, map, diamonds))
+        return paths;
+    if(!count && map.empty() && diamonds.empty() && solve_decomposed(source, last, false))
+        return paths;
+
+    PhaseTimer timer(stats, "backtracking");
     paths.clear();
-    visited.assign(n_vertices, false);
-    path.resize(n_vertices);
+    if(!searcher){
+        searcher = PathSearch::create(adj_list);
+        searcher->set_terminate(terminate);
+    }
 
-    backtracking(source, 0, last, count);
-    
-    std::vector< std::vector<int> > valid_paths;
-    for(auto candidate : paths)
-        if(valid(candidate, map, diamonds)) valid_paths.push_back(candidate);
-    
-    paths = valid_paths;
+    PathVisitor visitor = [this, count](const std::vector<int>& p){
+        paths.push_back(p);
+        return count;
+    };
+
+    if(count && n_threads > 1){
+        if(!pool)   pool.reset(new ThreadPool(n_threads));
+        searcher->search(source, last, map, diamonds, visitor, *pool, split_depth);
+    }
+    else{
+        searcher->search(source, last, map, diamonds, visitor);
+    }
 
     return paths;
 }
 
+long long Graph::count_paths(int source,
+                             int last,
+                             const std::vector< std::pair<int,int> >& map,
+                             const std::vector< std::pair<int,int> >& diamonds)
+{
+    PhaseTimer timer(stats, "count_paths");
+    std::string key, value;
+    if(cache){
+        key = ResultCache::key("count", adj_list, source, last, map, diamonds);
+        if(cache_find(key, value))  return std::stoll(value);
+    }
+
+    // paths of the kernel and of the graph correspond one to one
+    long long n_paths;
+    Kernel* k = build_kernel(source, last, map, diamonds);
+    if(k && (k->is_infeasible() || !k->is_trivial())){
+        n_paths = k->is_infeasible() ? 0 : kernel_graph->count_paths(k->get_source(), k->get_target());
+        if(cache && !(terminate && *terminate)) cache->store(key, std::to_string(n_paths));
+        return n_paths;
+    }
+
+    if(!counter)    counter.reset(new FrontierCounter(adj_list));
+    n_paths = counter->count(source, last, map, diamonds);
+    if(n_paths != COUNT_UNKNOWN){
+        if(cache)   cache->store(key, std::to_string(n_paths));
+        return n_paths;
+    }
+
+    if(!searcher){
+        searcher = PathSearch::create(adj_list);
+        searcher->set_terminate(terminate);
+    }
+    searcher->set_automorphisms(get_symmetry().get_automorphisms());
+
+    if(n_threads > 1){
+        if(!pool)   pool.reset(new ThreadPool(n_threads));
+        n_paths = searcher->search(source, last, map, diamonds, PathVisitor(), *pool, split_depth);
+    }
+    else{
+        n_paths = searcher->search(source, last, map, diamonds, PathVisitor());
+    }
+
+    if(cache && !(terminate && *terminate)) cache->store(key, std::to_string(n_paths));
+    return n_paths;
+}
+
 std::vector< std::vector<int> >&
 Graph::ham_cycle_bt(bool count,
                     const std::vector< std::pair<int,int> >& map,
@@ -554,13 +828,12 @@ Graph::ham_cycle_bt(bool count,
     }
     std::vector< std::vector<int> > sol;
 
-    for(int source : adj_list[min_deg_v]){
-        paths = ham_path_bt(source, min_deg_v, count, map, diamonds);
-        for(auto candidate : paths)
-            if(valid(candidate, map, diamonds)){
-                sol.push_back(candidate);
-                if(count) break;
-            }
+    std::vector< std::vector<Permutation> > images;
+    std::vector<int> sources = cycle_sources(min_deg_v, map, diamonds, images);
+    for(int k = 0; k < (int) sources.size(); k++){
+        paths = ham_path_bt(sources[k], min_deg_v, count, map, diamonds);
+        if(count)   add_images(paths, images[k]);
+        sol.insert(sol.end(), paths.begin(), paths.end());
         if(!count && !sol.empty())  break;
     }
     
@@ -575,8 +848,128 @@ std::vector< std::vector<int> >& Graph::ham_path(int source,
                                                  const std::vector< std::pair<int,int> >& map,
                                                  const std::vector< std::pair<int,int> >& diamonds)
 {
-    if(sat) return ham_path_sat(source, last, count, map, diamonds);
-    else    return ham_path_bt(source, last, count, map, diamonds);
+    if(count || !cache){
+        if(sat) return ham_path_sat(source, last, count, map, diamonds);
+        else    return ham_path_bt(source, last, count, map, diamonds);
+    }
+
+    // a single path is the same query for both engines
+    std::string key = ResultCache::key("path", adj_list, source, last, map, diamonds);
+    std::string value;
+    if(cache_find(key, value)){
+        // only definitive answers are stored
+        paths = string_to_path(value);
+        sat_status = paths.empty() ? SAT_UNSATISFIABLE : SAT_SATISFIABLE;
+        return paths;
+    }
+
+    if(sat) ham_path_sat(source, last, false, map, diamonds);
+    else    ham_path_bt(source, last, false, map, diamonds);
+
+    bool definitive = sat ? sat_status != SAT_UNKNOWN : !(terminate && *terminate);
+    if(definitive)  cache->store(key, path_to_string(paths));
+    return paths;
+}
+
+// creates an empty file with an unique name in the temporary directory
+static std::string temp_file(){
+    char name[] = "/tmp/rikudo_XXXXXX";
+    int fd = mkstemp(name);
+    if(fd < 0)
+        throw "Unable to create a temporary file";
+    close(fd);
+    return name;
+}
+
+std::vector< std::vector<int> >&
+Graph::ham_path_portfolio(int source,
+                          int last,
+                          const PortfolioOptions& options,
+                          const std::vector< std::pair<int,int> >& map,
+                          const std::vector< std::pair<int,int> >& diamonds)
+{
+    std::string key, value;
+    if(cache){
+        key = ResultCache::key("path", adj_list, source, last, map, diamonds);
+        if(cache_find(key, value)){
+            paths = string_to_path(value);
+            return paths;
+        }
+    }
+
+    std::atomic<bool> cancel(false);
+    std::mutex mutex;
+    std::condition_variable answered;
+    int n_running = (options.backtracking ? 1 : 0) + options.n_seeds + options.external_solvers.size();
+    bool decided = false;
+    std::vector<int> winner;
+
+    // called by every engine when it stops, solved tells if its answer is definitive
+    auto report = [&](bool solved, const std::vector<int>& found){
+        std::lock_guard<std::mutex> lock(mutex);
+        n_running--;
+        if(solved && !decided){
+            decided = true;
+            winner = found;
+            cancel = true;
+        }
+        answered.notify_all();
+    };
+
+    std::vector<std::thread> racers;
+    std::vector<std::string> temp_files;
+
+    if(options.backtracking){
+        racers.emplace_back([&](){
+            std::unique_ptr<PathSearch> search = PathSearch::create(adj_list);
+            search->set_terminate(&cancel);
+            std::vector<int> found;
+            search->search(source, last, map, diamonds, [&found](const std::vector<int>& p){
+                found = p;
+                return false;
+            });
+            report(!found.empty() || !cancel, found);
+        });
+    }
+
+    auto race_sat = [&](unsigned seed, const std::string& binary){
+        std::string input, output;
+        if(!binary.empty()){
+            input = temp_file();
+            output = temp_file();
+            temp_files.push_back(input);
+            temp_files.push_back(output);
+        }
+        racers.emplace_back([&, seed, binary, input, output](){
+            Graph racer(adj_list);
+            racer.set_encoding_options(encoding);
+            racer.set_sat_seed(seed);
+            if(!binary.empty()) racer.set_external_solver(binary, input, output);
+            racer.set_terminate(&cancel);
+            racer.ham_path_sat(source, last, false, map, diamonds);
+            std::vector<int> found = racer.paths.empty() ? std::vector<int>() : racer.paths[0];
+            report(racer.sat_status != SAT_UNKNOWN, found);
+        });
+    };
+    for(int seed = 0; seed < options.n_seeds; seed++)
+        race_sat(seed, "");
+    for(auto& binary : options.external_solvers)
+        race_sat(0, binary);
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        answered.wait(lock, [&]{ return decided || n_running == 0; });
+    }
+    cancel = true;
+    for(auto& racer : racers)
+        racer.join();
+    for(auto& file : temp_files)
+        std::remove(file.c_str());
+
+    paths.clear();
+    if(!winner.empty()) paths.push_back(winner);
+    if(cache && decided)    cache->store(key, path_to_string(paths));
+    return paths;
 }
 
 std::vector< std::vector<int> >& Graph::ham_cycle(bool sat,
@@ -596,97 +989,679 @@ Graph::k_paths(int k,
                const std::vector< std::pair<int, int> >& map,
                const std::vector< std::pair<int, int> >& diamonds)
 {
-    paths = ham_path_sat(source, last, false, map, diamonds);
-    if(paths.size() > k){
-        path.clear();
-        return path;
+    // a (k + 1)-th path is enough to tell there are too many
+    std::vector<int> first, found;
+    long long n_paths = 0;
+    {
+        std::unique_ptr<PathIterator> paths_left = iterate_paths(source, last, true, k + 1LL, map, diamonds);
+        while(paths_left->next(found)){
+            if(n_paths == 0)    first = found;
+            n_paths++;
+        }
     }
 
-    return paths[0]; 
+    path = n_paths > k ? std::vector<int>() : first;
+    return path;
 }
 
-void Graph::unique_sol(int first, int last, std::ofstream &ofile){
-    construct_sat(first, last);
-    solve_sat();
-    auto orig_path = read_sol();
+void Graph::unique_sol(int first, int last, std::ostream &ofile){
+    // without a fixed seed every call is meant to give a new puzzle
+    if(!cache || !fixed_shuffle){
+        solve_unique(first, last, ofile);
+        return;
+    }
+
+    // the puzzle found depends on the seed of the shuffle, and not minimising is asked
+    // for in the key
+    std::string mode = (minimise ? "unique-" : "unique-unminimised-") + std::to_string(shuffle_seed);
+    std::string key = ResultCache::key(mode, adj_list, first, last);
+    std::string value;
+    if(cache_find(key, value)){
+        n_min_calls = -1;
+        ofile << value;
+        return;
+    }
+
+    std::ostringstream out;
+    solve_unique(first, last, out);
+    if(!(terminate && *terminate))  cache->store(key, out.str());
+    ofile << out.str();
+}
+
+void Graph::solve_unique(int first, int last, std::ostream &ofile){
+    std::vector<int> orig_path;
+    n_min_calls = 0;
+
+    // the board may have a single solution the rules find alone
+    std::vector<int> no_cons;
+    Deduced deduced = deduce_cons(first, last, orig_path, no_cons, no_cons);
+    if(deduced != Deduced::PARTIAL){
+        if(deduced == Deduced::PATH)    orig_path = deduction->get_path();
+        write_min_cons(orig_path, no_cons, -1, ofile);
+        return;
+    }
+
+    if(use_portfolio){
+        PhaseTimer timer(stats, "portfolio");
+        auto& found = ham_path_portfolio(first, last, portfolio);
+        if(!found.empty())  orig_path = found[0];
+        construct_sat(first, last, {}, {}, exact_encoding());
+    }
+    else{
+        construct_sat(first, last, {}, {}, exact_encoding());
+        solve_sat();
+        orig_path = read_sol();
+    }
 
     if(orig_path.empty()){
         write_min_cons(orig_path, orig_path, -1, ofile);
         return;
     }
 
-    std::string ban = create_ban(orig_path);
-    int n_vars, n_clauses;
-    extend_sat(ban, n_vars, n_clauses);
+    // when the frontier counter knows the number of solutions, the ban is not solved
+    long long n_solutions;
+    {
+        PhaseTimer timer(stats, "count");
+        if(!counter)    counter.reset(new FrontierCounter(adj_list));
+        n_solutions = counter->count(first, last, {}, {});
+    }
 
-    recopy(n_vars, n_clauses);
-    solve_sat();
-    auto extra_path = read_sol();
-    if(extra_path.empty()){
-        write_min_cons(orig_path, extra_path, -1, ofile);
+    extend_sat(create_ban(orig_path));
+    if(n_solutions == COUNT_UNKNOWN){
+        solve_sat();
+        if(read_sol().empty())  n_solutions = 1;
+    }
+    if(n_solutions == 1){
+        write_min_cons(orig_path, no_cons, -1, ofile);
         return;
     }
     
     std::vector<int> cons = create_cons(n_vertices);
+    std::vector<int> act;
+    {
+        PhaseTimer timer(stats, "add_cons");
+        act = add_cons(orig_path, cons);
+    }
 
-    
     int lo = 0; // adding until lo-1 constraints will always produce solution
     int hi = cons.size() - 1; // adding hi or more will not produce more solutions
-    while(lo < hi){
-        int mid = lo + (hi-lo)/2;
+    {
+        PhaseTimer timer(stats, "binary_search");
+        if(n_threads > 1)   lo = hi = probe_parallel(first, last, orig_path, cons, act);
+        while(lo < hi){
+            int mid = lo + (hi-lo)/2;
+
+            // only the first mid+1 constraints are switched on
+            PhaseTimer probe(stats, "probe");
+            bool deduced;
+            bool unique = prefix_unique(first, last, orig_path, cons, act, mid, &deduced);
+            if(stats)   stats->add_probe(mid, unique, deduced, probe.seconds());
+
+            if(unique){
+                hi = mid;
+            }
+            else{
+                lo = mid + 1;
+            }
+        }
+    }
 
-        recopy(n_vars, n_clauses + mid + 1);
-        add_cons(orig_path, cons, mid);
-        solve_sat();
-        auto extra_path = read_sol();  
+    // in the end we have lo == hi
+    if(minimise){
+        PhaseTimer timer(stats, "minimise");
+        std::vector<int> kept = minimise_cons(first, last, orig_path, cons, act, lo);
+        write_min_cons(orig_path, kept, kept.size() - 1, ofile);
+    }
+    else{
+        write_min_cons(orig_path, cons, lo, ofile);
+    }
+}
+
+Deduced Graph::deduce_cons(int first, int last, const std::vector<int>& orig_path,
+                           const std::vector<int>& cons, const std::vector<int>& chosen){
+    PhaseTimer timer(stats, "deduction");
+    if(!deduction)  deduction.reset(new Deduction(adj_list));
+
+    std::vector< std::pair<int,int> > map, diamonds;
+    for(int i : chosen){
+        int con = cons[i];
+        if(con >= 0)    diamonds.push_back(std::make_pair(orig_path[con], orig_path[con+1]));
+        else            map.push_back(std::make_pair(-con, orig_path[-con]));
+    }
+    return deduction->deduce(first, last, map, diamonds);
+}
+
+bool Graph::prefix_unique(int first, int last, const std::vector<int>& orig_path,
+                          const std::vector<int>& cons, const std::vector<int>& act, int num,
+                          bool* deduced){
+    std::vector<int> prefix;
+    for(int i = 0; i <= num; i++)
+        prefix.push_back(i);
+    bool settled = deduce_cons(first, last, orig_path, cons, prefix) != Deduced::PARTIAL;
+    if(deduced) *deduced = settled;
+    if(settled) return true;
+
+    // the deduced positions hold in every solution, assuming them prunes the search
+    for(int i : prefix)
+        solver->assume(act[i]);
+    for(auto ith_vertex : deduction->get_fixed())
+        solver->assume(encode(ith_vertex.first, ith_vertex.second));
+    solve_sat();
+    return sat_status != SAT_SATISFIABLE;
+}
 
-        if(extra_path.empty()){
-            hi = mid;
+std::vector<int> Graph::minimise_cons(int first, int last, const std::vector<int>& orig_path,
+                                      const std::vector<int>& cons, const std::vector<int>& act, int num){
+    n_min_calls = 0;
+
+    // indices of the constraints still in the set
+    std::vector<int> kept;
+    for(int i = 0; i <= num; i++)
+        kept.push_back(i);
+
+    // only the constraints of the final conflict are needed
+    auto keep_failed = [this, &act](std::vector<int>& set, int removed){
+        std::vector<int> rest;
+        for(int i : set)
+            if(i != removed && solver->failed(act[i]))  rest.push_back(i);
+        set.swap(rest);
+    };
+
+    for(int i : kept)
+        solver->assume(act[i]);
+    n_min_calls++;
+    if(solver->solve() == SAT_UNSATISFIABLE)
+        keep_failed(kept, -1);
+
+    // the constraints before position j are necessary, and stay in every final
+    // conflict since the set only shrinks
+    for(int j = 0; j < (int) kept.size(); ){
+        int candidate = kept[j];
+        std::vector<int> rest;
+        for(int i : kept)
+            if(i != candidate)  rest.push_back(i);
+        if(deduce_cons(first, last, orig_path, cons, rest) == Deduced::PATH){
+            kept.swap(rest);
+            continue;
         }
-        else{
-            lo = mid + 1;
+
+        for(int i : kept)
+            if(i != candidate)  solver->assume(act[i]);
+        n_min_calls++;
+        if(solver->solve() == SAT_UNSATISFIABLE)
+            keep_failed(kept, candidate);
+        else
+            j++;
+    }
+
+    std::vector<int> min_cons;
+    for(int i : kept)
+        min_cons.push_back(cons[i]);
+    return min_cons;
+}
+
+void Graph::set_minimise(bool minimise){
+    this->minimise = minimise;
+}
+
+void Graph::set_cache(ResultCache* cache){
+    this->cache = cache;
+}
+
+void Graph::set_stats(Stats* stats){
+    this->stats = stats;
+    if(solver)  solver->set_stats(stats);
+}
+
+long long Graph::get_min_calls(){
+    return n_min_calls;
+}
+
+void Graph::set_kernelise(bool kernelise){
+    this->kernelise = kernelise;
+}
+
+void Graph::set_decompose(bool decompose){
+    this->decompose = decompose;
+}
+
+const Kernel* Graph::get_kernel() const{
+    return kernel.get();
+}
+
+Kernel* Graph::build_kernel(int source, int last,
+                            const std::vector< std::pair<int,int> >& map,
+                            const std::vector< std::pair<int,int> >& diamonds){
+    if(!kernelise || !map.empty() || !diamonds.empty())
+        return nullptr;
+    if(!kernel || kernel_ends != std::make_pair(source, last)){
+        PhaseTimer timer(stats, "kernel");
+        kernel.reset(new Kernel(adj_list, source, last));
+        kernel_ends = std::make_pair(source, last);
+        kernel_graph.reset();
+        if(!kernel->is_infeasible() && !kernel->is_trivial())
+            kernel_graph.reset(new Graph(kernel->get_adj_list()));
+        if(stats){
+            stats->add("kernel_vertices_removed", kernel->get_removed_vertices());
+            stats->add("kernel_edges_removed", kernel->get_removed_edges());
         }
     }
 
-    // in the end we have lo == hi
-    write_min_cons(orig_path, cons, lo, ofile);
+    // the kernel is solved with the current options of this graph
+    if(kernel_graph){
+        kernel_graph->sat_backend = sat_backend;
+        kernel_graph->external_solver = external_solver;
+        kernel_graph->external_input = external_input;
+        kernel_graph->external_output = external_output;
+        kernel_graph->encoding = encoding;
+        kernel_graph->sat_seed = sat_seed;
+        kernel_graph->fixed_shuffle = fixed_shuffle;
+        kernel_graph->shuffle_seed = shuffle_seed;
+        kernel_graph->stats = stats;
+        kernel_graph->kernelise = false;
+        kernel_graph->decompose = decompose;
+        kernel_graph->set_terminate(terminate);
+        kernel_graph->set_parallelism(n_threads, split_depth);
+    }
+    return kernel.get();
 }
 
-void Graph::extend_sat(std::string s, int &n_vars, int &n_clauses){
-    std::ifstream ifile(get_path(sat_input));
-    std::ofstream ofile(get_path(sat_aux_input));
-    
-    std::string line;
-    std::string token;
+bool Graph::solve_on_kernel(int source, int last, bool sat, bool count,
+                            const std::vector< std::pair<int,int> >& map,
+                            const std::vector< std::pair<int,int> >& diamonds){
+    // without fewer vertices the formula keeps its size, the graph itself is solved
+    Kernel* k = build_kernel(source, last, map, diamonds);
+    if(!k || (!k->is_infeasible() && k->get_removed_vertices() == 0))
+        return false;
 
-    getline(ifile, line);
-    std::istringstream iss(line);
-    
-    for(int i = 0; i < 2; i++){
-        iss >> token;
+    paths.clear();
+    if(k->is_infeasible()){
+        sat_status = SAT_UNSATISFIABLE;
+        return true;
     }
-    iss >> n_vars;
-    iss >> n_clauses;
-    n_clauses++;
-    
-    while(getline(ifile, line)){
-        ofile << line << "\n";
+
+    auto& found = sat ? kernel_graph->ham_path_sat(k->get_source(), k->get_target(), count, {}, {})
+                      : kernel_graph->ham_path_bt(k->get_source(), k->get_target(), count, {}, {});
+    for(auto& p : found)
+        paths.push_back(k->lift(p));
+    sat_status = kernel_graph->sat_status;
+    return true;
+}
+
+bool Graph::solve_decomposed(int source, int last, bool sat){
+    if(!decompose)  return false;
+    PhaseTimer timer(stats, "decomposition");
+
+    // every block is solved by a graph of its own, with the options of this one
+    BlockSolver solver = [this, sat](const std::vector< std::vector<int> >& block, int s, int t){
+        std::vector<std::string> temp_files;
+        std::unique_ptr<Graph> copy = worker_copy(block, temp_files);
+        copy->configure_like(*this);
+        copy->decompose = false;
+        auto& found = sat ? copy->ham_path_sat(s, t, false, {}, {})
+                          : copy->ham_path_bt(s, t, false, {}, {});
+        std::vector<int> block_path = found.empty() ? std::vector<int>() : found[0];
+        for(auto& file : temp_files)
+            std::remove(file.c_str());
+        return block_path;
+    };
+
+    Decomposition decomposition(adj_list, n_threads);
+    std::vector<int> found;
+    if(!decomposition.solve(source, last, solver, found))
+        return false;
+
+    if(stats)   stats->add("blocks", decomposition.get_n_blocks());
+    paths.clear();
+    if(!found.empty())  paths.push_back(found);
+    sat_status = found.empty() ? SAT_UNSATISFIABLE : SAT_SATISFIABLE;
+    return true;
+}
+
+void Graph::configure_like(const Graph& other){
+    encoding = other.encoding;
+    sat_seed = other.sat_seed;
+    fixed_shuffle = other.fixed_shuffle;
+    shuffle_seed = other.shuffle_seed;
+    use_portfolio = other.use_portfolio;
+    portfolio = other.portfolio;
+    minimise = other.minimise;
+    kernelise = other.kernelise;
+    decompose = other.decompose;
+    cache = other.cache;
+    set_terminate(other.terminate);
+    set_parallelism(other.n_threads, other.split_depth);
+}
+
+std::unique_ptr<Graph> Graph::worker_copy(std::vector<std::string>& temp_files){
+    return worker_copy(adj_list, temp_files);
+}
+
+std::unique_ptr<Graph> Graph::worker_copy(const std::vector< std::vector<int> >& adj_list,
+                                          std::vector<std::string>& temp_files){
+    std::unique_ptr<Graph> copy(new Graph(adj_list));
+    copy->set_encoding_options(exact_encoding());
+    copy->set_sat_seed(sat_seed);
+    copy->set_terminate(terminate);
+    if(sat_backend == SatBackend::EXTERNAL){
+        std::string binary = external_solver.empty() ? get_path("") + "../lib/" + sat_solver
+                                                     : external_solver;
+        temp_files.push_back(temp_file());
+        temp_files.push_back(temp_file());
+        copy->set_external_solver(binary, temp_files[temp_files.size() - 2], temp_files.back());
+    }
+    return copy;
+}
+
+int Graph::probe_parallel(int first, int last, std::vector<int>& orig_path,
+                          std::vector<int>& cons, const std::vector<int>& act){
+    if(!pool)   pool.reset(new ThreadPool(n_threads));
+    int k = pool->size();
+
+    // worker 0 uses this graph, the others a copy holding the same formula
+    std::vector< std::unique_ptr<Graph> > copies(k);
+    std::vector<Graph*> workers(k, this);
+    std::vector<std::string> temp_files;
+    for(int w = 1; w < k; w++){
+        copies[w] = worker_copy(temp_files);
+        Graph& copy = *copies[w];
+        workers[w] = &copy;
+        pool->submit([&copy, first, last, &orig_path, &cons](int){
+            copy.construct_sat(first, last, {}, {}, copy.encoding);
+            copy.extend_sat(copy.create_ban(orig_path));
+            copy.add_cons(orig_path, cons);
+        });
     }
+    pool->wait();
 
-    ofile << s;
+    int lo = 0;
+    int hi = cons.size() - 1;
+    while(lo < hi){
+        std::vector<int> mids;
+        for(int j = 1; j <= k; j++){
+            int mid = lo + (long long) (hi - lo) * j / (k + 1);
+            if(mid < hi && (mids.empty() || mids.back() != mid))
+                mids.push_back(mid);
+        }
+
+        // unique[j] is true if the first mids[j]+1 constraints leave a single path
+        std::vector<char> unique(mids.size());
+        std::vector<char> deduced(mids.size());
+        std::vector<double> seconds(mids.size());
+        for(int j = 0; j < (int) mids.size(); j++){
+            pool->submit([&, j](int worker){
+                auto start = std::chrono::steady_clock::now();
+                Graph& graph = *workers[worker];
+                bool settled;
+                unique[j] = graph.prefix_unique(first, last, orig_path, cons, act, mids[j], &settled);
+                deduced[j] = settled;
+                seconds[j] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            });
+        }
+        pool->wait();
+        if(stats){
+            for(int j = 0; j < (int) mids.size(); j++)
+                stats->add_probe(mids[j], unique[j], deduced[j], seconds[j]);
+        }
+
+        for(int j = (int) mids.size() - 1; j >= 0; j--)
+            if(unique[j])   hi = mids[j];
+        for(int j = 0; j < (int) mids.size(); j++)
+            if(!unique[j])  lo = std::max(lo, mids[j] + 1);
+    }
 
-    ofile.close();
-    ifile.close();
+    for(auto& file : temp_files)
+        std::remove(file.c_str());
+
+    return lo;
+}
+
+bool Graph::joins(int source, int target, std::vector<int>& found){
+    std::vector<int> no_cons;
+    found.clear();
+    Deduced deduced = deduce_cons(source, target, no_cons, no_cons, no_cons);
+    if(deduced != Deduced::PARTIAL){
+        if(deduced == Deduced::PATH)    found = deduction->get_path();
+        return deduced == Deduced::PATH;
+    }
+
+    solver->assume(encode(0, source));
+    solver->assume(encode(n_vertices - 1, target));
+    for(auto ith_vertex : deduction->get_fixed())
+        solver->assume(encode(ith_vertex.first, ith_vertex.second));
+    if(!solve_sat())    return false;
+    found = read_sol();
+    return true;
 }
 
-std::string Graph::create_ban(std::vector<int> &orig_path){
+// marks the pairs of endpoints of the paths obtained from a hamiltonian path of an
+// undirected graph by rotations: if the first vertex is adjacent to path[i], reversing
+// path[0..i-1] gives a path from path[i-1]; only paths with a new pair are rotated again
+static void rotate_path(const std::vector< std::vector<int> >& adj_list, const std::vector<int>& path,
+                        const std::function<int(int,int)>& root, std::vector<char>& joined){
+    int n = path.size();
+    std::vector< std::vector<int> > queue(1, path);
+    joined[root(path[0], path[n - 1])] = 1;
+    for(int k = 0; k < (int) queue.size(); k++){
+        for(int end = 0; end < 2; end++){
+            std::vector<int> p(queue[k]);
+            if(end) std::reverse(p.begin(), p.end());
+            std::vector<int> position(n);
+            for(int i = 0; i < n; i++)
+                position[p[i]] = i;
+            for(int w : adj_list[p[0]]){
+                int i = position[w];
+                if(i < 2 || joined[root(p[i - 1], p[n - 1])])    continue;
+                joined[root(p[i - 1], p[n - 1])] = 1;
+                std::vector<int> rotated(p);
+                std::reverse(rotated.begin(), rotated.begin() + i);
+                queue.push_back(rotated);
+            }
+        }
+        queue[k].clear();
+    }
+}
+
+std::vector< std::vector<char> > Graph::feasible_pairs(){
+    PhaseTimer timer(stats, "pairs");
+    int n = n_vertices;
+    std::vector< std::vector<char> > feasible(n, std::vector<char>(n, 0));
+
+    std::string key, value;
+    if(cache){
+        key = ResultCache::key("pairs", adj_list, -1, -1);
+        if(cache_find(key, value) && (int) value.size() == n * n){
+            for(int s = 0; s < n; s++)
+                for(int t = 0; t < n; t++)
+                    feasible[s][t] = value[s * n + t] == '1';
+            return feasible;
+        }
+    }
+
+    // pair (s, t) is number s * n + t
+    std::vector<char> candidate(n * n);
+    EndpointFilter filter(adj_list);
+    {
+        PhaseTimer rules(stats, "pair_rules");
+        for(int s = 0; s < n; s++)
+            for(int t = 0; t < n; t++)
+                candidate[s * n + t] = filter.may_join(s, t);
+    }
+
+    // orbits of the pairs under the automorphisms and the reversal of undirected paths,
+    // the roots of the union-find being the smallest pairs of their orbits
+    std::vector<int> parent(n * n);
+    for(int p = 0; p < n * n; p++)
+        parent[p] = p;
+    auto find = [&parent](int p){
+        while(parent[p] != p){
+            parent[p] = parent[parent[p]];
+            p = parent[p];
+        }
+        return p;
+    };
+    auto unite = [&](int p, int q){
+        p = find(p);
+        q = find(q);
+        if(p != q)  parent[std::max(p, q)] = std::min(p, q);
+    };
+    const std::vector<Permutation>& automorphisms = get_symmetry().get_automorphisms();
+    for(int s = 0; s < n; s++)
+        for(int t = 0; t < n; t++){
+            if(filter.is_symmetric())   unite(s * n + t, t * n + s);
+            for(auto& perm : automorphisms)
+                unite(s * n + t, perm[s] * n + perm[t]);
+        }
+
+    // the pairs of an orbit share their answer, so a rule rejecting one rejects all
+    std::vector<char> allowed(n * n, 1);
+    for(int p = 0; p < n * n; p++)
+        if(!candidate[p])   allowed[find(p)] = 0;
+    std::vector< std::pair<int,int> > pending;
+    for(int p = 0; p < n * n; p++)
+        if(find(p) == p && allowed[p])
+            pending.push_back(std::make_pair(p / n, p % n));
+    if(stats)
+        stats->add("pairs_rejected", std::count(candidate.begin(), candidate.end(), 0));
+
+    // joined[root] is set once a path of the orbit is known, solved[root] once tested
+    std::vector<char> joined(n * n, 0), solved(n * n, 0);
+    std::mutex joined_mutex;
+    auto root = [&find, n](int s, int t){ return find(s * n + t); };
+    auto test = [&](Graph& worker, int s, int t){
+        {
+            std::lock_guard<std::mutex> lock(joined_mutex);
+            if(joined[root(s, t)])  return;
+        }
+        std::vector<int> found;
+        bool ok = worker.joins(s, t, found);
+        std::lock_guard<std::mutex> lock(joined_mutex);
+        solved[root(s, t)] = 1;
+        if(ok && filter.is_symmetric())  rotate_path(adj_list, found, root, joined);
+        else if(ok)                      joined[root(s, t)] = 1;
+    };
+
+    if(!pending.empty()){
+        PhaseTimer solving(stats, "pair_solve");
+        construct_sat(-1, -1, {}, {}, exact_encoding());
+
+        if(n_threads > 1 && pending.size() > 1){
+            if(!pool)   pool.reset(new ThreadPool(n_threads));
+            int k = pool->size();
+
+            // worker 0 uses this graph, the others a copy holding the same formula
+            std::vector< std::unique_ptr<Graph> > copies(k);
+            std::vector<Graph*> workers(k, this);
+            std::vector<std::string> temp_files;
+            for(int w = 1; w < k; w++){
+                copies[w] = worker_copy(temp_files);
+                Graph& copy = *copies[w];
+                workers[w] = &copy;
+                pool->submit([&copy](int){
+                    copy.construct_sat(-1, -1, {}, {}, copy.encoding);
+                });
+            }
+            pool->wait();
+
+            for(auto s_t : pending){
+                pool->submit([&, s_t](int worker){
+                    test(*workers[worker], s_t.first, s_t.second);
+                });
+            }
+            pool->wait();
+
+            for(auto& file : temp_files)
+                std::remove(file.c_str());
+        }
+        else{
+            for(auto s_t : pending)
+                test(*this, s_t.first, s_t.second);
+        }
+    }
+    if(stats)
+        stats->add("pairs_solved", std::count(solved.begin(), solved.end(), 1));
+
+    for(int p = 0; p < n * n; p++)
+        feasible[p / n][p % n] = joined[find(p)];
+
+    if(cache && !(terminate && *terminate)){
+        value.clear();
+        for(int p = 0; p < n * n; p++)
+            value += feasible[p / n][p % n] ? '1' : '0';
+        cache->store(key, value);
+    }
+    return feasible;
+}
+
+void Graph::ablation(int source, int dest, int trials, std::ostream &out){
+    const char* names[] = {"transitivity", "total-order", "correlation", "first-order",
+                           "last-order", "first-position", "last-position", "successor",
+                           "symmetry-breaking"};
+    int first_condition = 8;
+    int n_families = 9;
+
+    out << "condition family enabled clauses encode_seconds solve_seconds change\n";
+
+    // condition13 (14) is added anyway while the order relation does not pin the first
+    // (last) vertex, so switching it is left out then
+    unsigned first_order = TRANSITIVITY | TOTAL_ORDER | CORRELATION | FIRST_ORDER;
+    unsigned last_order = TRANSITIVITY | TOTAL_ORDER | CORRELATION | LAST_ORDER;
+
+    // every trial runs the solver with a seed of its own, so that the mean is taken
+    // over different searches
+    unsigned base_seed = sat_seed;
+    double base_time = 0;
+    for(int f = -1; f < n_families; f++){
+        EncodingOptions options = encoding;
+        if(f >= 0)  options.families ^= 1u << (first_condition + f);
+
+        unsigned bit = f >= 0 ? 1u << (first_condition + f) : 0;
+        if(bit == FIRST_POSITION && (options.families & first_order) != first_order)    continue;
+        if(bit == LAST_POSITION && (options.families & last_order) != last_order)       continue;
+
+        double encode_total = 0, solve_total = 0;
+        for(int trial = 0; trial < trials; trial++){
+            sat_seed = base_seed + trial;
+            auto start = std::chrono::steady_clock::now();
+            construct_sat(source, dest, {}, {}, options);
+            auto encoded = std::chrono::steady_clock::now();
+            solve_sat();
+            std::chrono::duration<double> encode_time = encoded - start;
+            std::chrono::duration<double> solve_time = std::chrono::steady_clock::now() - encoded;
+            encode_total += encode_time.count();
+            solve_total += solve_time.count();
+        }
+        sat_seed = base_seed;
+        double encode_mean = encode_total / trials;
+        double mean = solve_total / trials;
+
+        if(f < 0){
+            base_time = mean;
+            out << "- default - " << n_clauses << " " << encode_mean << " " << mean << " 0%\n";
+            continue;
+        }
+
+        bool enabled = (options.families >> (first_condition + f)) & 1;
+        out << first_condition + f << " " << names[f] << " " << (enabled ? "on" : "off") << " "
+            << n_clauses << " " << encode_mean << " " << mean << " "
+            << (mean - base_time) / base_time * 100 << "%\n";
+    }
+}
+
+// adds a clause to the live solver
+void Graph::extend_sat(const std::vector<int> &clause){
+    PhaseTimer timer(stats, "extend_sat");
+    n_clauses++;
+    solver->add_clause(clause);
+}
+
+std::vector<int> Graph::create_ban(std::vector<int> &orig_path){
     int n_vertices = orig_path.size();
-    std::string ban = "";
+    std::vector<int> ban;
     for(int i = 1; i < n_vertices - 1; i++){
         int var = -encode(i, orig_path[i]);
-        ban += std::to_string(var) + " ";
+        ban.push_back(var);
     }
-    ban += "0\n";
 
     return ban;
 }
@@ -702,7 +1677,7 @@ std::vector<int> Graph::create_cons(int n_vertices){
         cons.push_back(-i);
     
     std::random_device rd;
-    std::mt19937 g(rd());
+    std::mt19937 g(fixed_shuffle ? shuffle_seed : rd());
  
     std::shuffle(cons.begin(), cons.end(), g);
 
@@ -713,70 +1688,58 @@ std::string get_path(std::string file_name){
     char buffer[1024];  
     int buffer_size = 1024;
     
-    readlink("/proc/self/exe", buffer, buffer_size);
+    ssize_t len = readlink("/proc/self/exe", buffer, buffer_size - 1);
+    buffer[len < 0 ? 0 : len] = '\0';
     std::string path(dirname(buffer));
     path = path + "/" + file_name;
     return path;
 }
 
-void Graph::recopy(int n_vars, int n_clauses){
-    std::ifstream ifile(get_path(sat_aux_input));
-    std::ofstream ofile(get_path(sat_input));
-    
-    ofile << "p cnf " << n_vars << " " << n_clauses << "\n";
-
-    std::string line;
-    while(getline(ifile, line)){
-        ofile << line << "\n";
-    }
-
-    ofile.close();
-    ifile.close();
+int Graph::new_var(){
+    return ++n_vars;
 }
 
-void Graph::add_cons(std::vector<int>& orig_path, std::vector<int>& cons, int pos){
-    std::ofstream ofile;
-    ofile.open(get_path(sat_input), std::ofstream::app);
-
+std::vector<int> Graph::add_cons(std::vector<int>& orig_path, std::vector<int>& cons){
+    std::vector<int> act;
     int n_vertices = orig_path.size();
-    for(int i = 0; i <= pos; i++){
-        int con = cons[i];
+    for(int con : cons){
+        int guard = new_var();
+        act.push_back(guard);
         if(con >= 0){
             int u = orig_path[con];
             int v = orig_path[con+1];
-            std::string diam = diam_s(u, v, n_vertices);
-            ofile << diam;
+            add_diam(u, v, n_vertices, guard);
         }
         else{
             con = -con;
             int var = encode(con, orig_path[con]);
-            ofile << std::to_string(var) << " 0\n";
+            solver->add(-guard);
+            solver->add(var);
+            solver->add(0);
         }
     }
 
-    ofile.close();
+    return act;
 }
 
-std::string Graph::diam_s(int u, int v, int n_vertices){
-    std::string s;
+void Graph::add_diam(int u, int v, int n_vertices, int guard){
     for(int i = 0; i < n_vertices; i++){
-
         int u_id = -encode(i, u);
-        s += std::to_string(u_id);
+        solver->add(-guard);
+        solver->add(u_id);
         if(i > 0){
             int v1_id = encode(i-1, v);
-            s += " " + std::to_string(v1_id);
+            solver->add(v1_id);
         }
         if(i < n_vertices-1){
             int v2_id = encode(i+1, v);
-            s += " " + std::to_string(v2_id);                
+            solver->add(v2_id);
         }
-        s += " 0\n";
+        solver->add(0);
     }
-    return s;
 }
 
-void Graph::write_min_cons(std::vector<int>& orig_path, std::vector<int>& cons, int num, std::ofstream &ofile){
+void Graph::write_min_cons(std::vector<int>& orig_path, std::vector<int>& cons, int num, std::ostream &ofile){
     for(int v : orig_path){
         ofile << v << "\n";
     }
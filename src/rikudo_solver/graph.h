@@ -7,10 +7,89 @@
 
 #include <vector>
 #include <fstream>
+#include <memory>
+#include <string>
+#include "sat_solver.h"
+#include "amo_encoding.h"
+#include "path_search.h"
+#include "frontier_counter.h"
+#include "deduction.h"
+#include "symmetry.h"
+#include "result_cache.h"
+#include "kernel.h"
+#include "decomposition.h"
+#include "path_iterator.h"
 
 
 std::string get_path(std::string file_name);
 
+/**
+ * Redundant clause families of Graph::construct_sat that can be switched on and off.
+ * The bit of a family is 1 << the number of the condition generating it.
+ */
+const unsigned TRANSITIVITY = 1u << 8;     // condition8, O(n^3)
+const unsigned TOTAL_ORDER = 1u << 9;      // condition9, O(n^2)
+const unsigned CORRELATION = 1u << 10;     // condition10, O(n^3)
+const unsigned FIRST_ORDER = 1u << 11;     // condition11, O(n)
+const unsigned LAST_ORDER = 1u << 12;      // condition12, O(n)
+const unsigned FIRST_POSITION = 1u << 13;  // condition13, 1 clause
+const unsigned LAST_POSITION = 1u << 14;   // condition14, 1 clause
+const unsigned SUCCESSOR = 1u << 15;       // condition15, O(n*|E|)
+const unsigned SYMMETRY_BREAKING = 1u << 16; // condition16, O(|E|)
+
+/**
+ * order relation of condition8 to condition12
+ */
+const unsigned ORDER_RELATION = TRANSITIVITY | TOTAL_ORDER | CORRELATION | FIRST_ORDER | LAST_ORDER;
+
+/**
+ * Engines raced by Graph::ham_path_portfolio
+ */
+struct PortfolioOptions
+{
+    /**
+     * whether the backtracking search takes part in the race
+     */
+    bool backtracking;
+
+    /**
+     * number of embedded SAT solvers, each one with its own seed
+     */
+    int n_seeds;
+
+    /**
+     * paths of external solver binaries, which read a DIMACS file given as argument
+     * and print the answer in the SAT competition format
+     */
+    std::vector<std::string> external_solvers;
+
+    PortfolioOptions() : backtracking(true), n_seeds(1) {}
+};
+
+/**
+ * Options controlling the formula built by Graph::construct_sat
+ */
+struct EncodingOptions
+{
+    /**
+     * encoding of the "at most one" constraints of condition2 and condition4
+     */
+    AmoEncoding amo;
+
+    /**
+     * redundant clause families added to the formula, see TRANSITIVITY and the
+     * constants that follow it
+     * the endpoints are always fixed: condition13 and condition14 are added anyway
+     * when the order relation cannot imply them
+     * condition16 removes solutions, so it is left out of the formulas whose solutions
+     * are enumerated or proved unique
+     */
+    unsigned families;
+
+    EncodingOptions() : amo(AmoEncoding::BIMANDER),
+                        families(FIRST_POSITION | LAST_POSITION | SUCCESSOR | SYMMETRY_BREAKING) {}
+};
+
 
 class Graph
 {
@@ -31,10 +110,53 @@ private:
     std::vector< std::vector<int> > adj_list;
     
     /**
-     * list of visited vertices in a partial path
-     * this variable is used in the method 'backtracking'
+     * search engine used by ham_path_bt, built on its first use with the vertex
+     * set width that fits n_vertices
+     */
+    std::unique_ptr<PathSearch> searcher;
+
+    /**
+     * frontier dynamic program used by count_paths and unique_sol, built on its first use
+     */
+    std::unique_ptr<FrontierCounter> counter;
+
+    /**
+     * deduction rules tried by unique_sol before calling the solver, built on their first use
+     */
+    std::unique_ptr<Deduction> deduction;
+
+    /**
+     * automorphisms of the graph, computed on their first use by the counting search,
+     * the cycle search and condition16
+     */
+    std::unique_ptr<Symmetry> symmetry;
+
+    /**
+     * whether path queries without constraints are solved on the kernel of the graph,
+     * the kernel for the endpoints of the last one and the graph built from it
+     */
+    bool kernelise;
+    std::pair<int,int> kernel_ends;
+    std::unique_ptr<Kernel> kernel;
+    std::unique_ptr<Graph> kernel_graph;
+
+    /**
+     * whether single path queries without constraints are split at the necks of the
+     * graph (see Decomposition)
+     */
+    bool decompose;
+
+    /**
+     * number of threads used by the backtracking search in count mode and depth
+     * at which its search tree is split into tasks
+     */
+    int n_threads;
+    int split_depth;
+
+    /**
+     * workers of the parallel searches, built on their first use
      */
-    std::vector<bool> visited;
+    std::unique_ptr<ThreadPool> pool;
 
     /**
      * list of hamiltonian paths/cycles computed
@@ -48,6 +170,85 @@ private:
      */
     std::vector<int> path;
 
+    /**
+     * backend used to build new SAT solvers
+     */
+    SatBackend sat_backend;
+
+    /**
+     * options used when the formula is built by ham_path, ham_cycle or unique_sol
+     */
+    EncodingOptions encoding;
+
+    /**
+     * binary and files of the external backend, the defaults next to the executable
+     * are used when empty
+     */
+    std::string external_solver;
+    std::string external_input;
+    std::string external_output;
+
+    /**
+     * seed of the embedded solvers
+     */
+    unsigned sat_seed;
+
+    /**
+     * whether unique_sol shuffles the candidate constraints with a fixed seed, and the seed
+     */
+    bool fixed_shuffle;
+    unsigned shuffle_seed;
+
+    /**
+     * flag that cancels the running SAT solvers and searches when set, or nullptr
+     */
+    const std::atomic<bool>* terminate;
+
+    /**
+     * whether unique_sol finds its base path with ham_path_portfolio, and the engines raced
+     */
+    bool use_portfolio;
+    PortfolioOptions portfolio;
+
+    /**
+     * whether unique_sol minimises the constraints found by the binary search, and
+     * number of calls to the solver made by the last minimisation
+     */
+    bool minimise;
+    long long n_min_calls;
+
+    /**
+     * measures of the run, or nullptr when stats are off
+     */
+    Stats* stats;
+
+    /**
+     * results of earlier runs, or nullptr when they are not kept
+     */
+    ResultCache* cache;
+
+    /**
+     * solver holding the formula built by the last call to construct_sat
+     * it is kept alive between queries so that learned clauses are reused
+     */
+    std::unique_ptr<SatSolver> solver;
+
+    /**
+     * number of clauses of the formula built by the last call to construct_sat
+     */
+    long long n_clauses;
+
+    /**
+     * number of propositional variables of the formula, including the
+     * auxiliary ones allocated by new_var
+     */
+    int n_vars;
+
+    /**
+     * result of the last call to solve_sat
+     */
+    int sat_status;
+
     
     /**
      * @brief Returns index of propositional variable coding a vertex visited
@@ -62,34 +263,6 @@ private:
 
     void decode(int var, int &i, int &v);
 
-    /**
-     * @brief Recursive function that tries to find hamiltonian paths in the graph
-     * that ends at vertex 'last'
-     * 
-     * @param v index of current vertex
-     * @param n number of vertices already visited
-     * @param last last vertex in the path
-     * @param count true if we are counting the total number of existing hamiltonian paths
-     * @return true if there is a hamiltonian path ending at vertex 'last' and
-     * whose 'n'-th visited vertex is 'v' 
-     */
-    bool backtracking(int v, int n, int last, bool count);
-
-    /**
-     * @brief Checks if given candidate path is a valid path
-     * 
-     * @param candidate hamiltonian path that might or not respect the conditions
-     * given by map and diamonds arguments
-     * @param map list of pairs of integers of the form (i, v) representing
-     * the condition "vertex v must be visited at instant i"
-     * @param diamonds list of diamonds in the form of a list of pairs of integers of the form (u, v) representing
-     * the condition "vertex v and vertex u must be visited consecutively, in any order"
-     * @return true if candidate path is a valid path
-     */
-    bool valid(const std::vector<int> &candidate,
-                  const std::vector< std::pair<int,int> >& map,
-                  const std::vector< std::pair<int,int> >& diamonds);
-
     /**
      * @brief returns a vector of hamiltonian paths 
      * 
@@ -109,6 +282,21 @@ private:
                  const std::vector< std::pair<int,int> >& map,
                  const std::vector< std::pair<int,int> >& diamonds);
 
+    /**
+     * @brief Enumerates the hamiltonian paths with a single live solver
+     * @details Every model found is banned by a clause over the position variables of
+     * the inner vertices of its path, and the solver goes on from what it learned
+     *
+     * @param visitor function called for every path found, the enumeration stops when
+     * it returns false, an empty function only counts the paths
+     * @return number of paths found
+     */
+    long long enumerate_sat(int source,
+                            int last,
+                            const PathVisitor& visitor,
+                            const std::vector< std::pair<int,int> >& map,
+                            const std::vector< std::pair<int,int> >& diamonds);
+
     /**
      * @brief returns a vector of hamiltonian cycles
      * 
@@ -121,7 +309,8 @@ private:
 
     /**
      * @brief returns a vector of hamiltonian paths
-     * @detail this methods uses a backtracking approach
+     * @detail this methods uses a backtracking approach, the constraints are
+     * checked during the search, see PathSearch
      * 
      * @param source origin of the path
      * @param last destination of the path
@@ -158,45 +347,246 @@ private:
     
 
     
-    std::string create_ban(std::vector<int> &orig_path);
-    void extend_sat(std::string s, int &n_vars, int &n_clauses);
+    /**
+     * @brief Returns the automorphisms of the graph, computing them on the first call
+     */
+    Symmetry& get_symmetry();
+
+    /**
+     * @brief Returns the encoding options without the families that remove solutions,
+     * for the formulas whose every solution matters
+     */
+    EncodingOptions exact_encoding();
+
+    /**
+     * @brief Looks a query up in the result cache, counting hits and misses in the stats
+     *
+     * @param key key built by ResultCache::key
+     * @param value set to the stored result when it is found
+     * @return true if the cache is on and holds the key
+     */
+    bool cache_find(const std::string& key, std::string& value);
+
+    /**
+     * @brief Builds the kernel of the graph for a pair of endpoints, unless it is the
+     * current one, and the graph that solves the queries on it
+     * @return the kernel, or nullptr when kernelisation is off or there are constraints
+     */
+    Kernel* build_kernel(int source, int last,
+                         const std::vector< std::pair<int,int> >& map,
+                         const std::vector< std::pair<int,int> >& diamonds);
+
+    /**
+     * @brief Answers a query of ham_path_sat or ham_path_bt on the kernel of the graph
+     * @details The paths found are lifted to the graph and left in paths, and sat_status
+     * is the one of the kernel
+     *
+     * @return false if the kernel has as many vertices as the graph, the query being
+     * then left to the caller
+     */
+    bool solve_on_kernel(int source, int last, bool sat, bool count,
+                         const std::vector< std::pair<int,int> >& map,
+                         const std::vector< std::pair<int,int> >& diamonds);
+
+    /**
+     * @brief Answers a query of ham_path_sat or ham_path_bt for a single path by
+     * splitting the graph at its necks, each block being solved by a graph of its own
+     * @details The path found is left in paths and sat_status tells whether there is one
+     *
+     * @return false if the graph has no neck, the query being then left to the caller
+     */
+    bool solve_decomposed(int source, int last, bool sat);
+
+    /**
+     * @brief Finds the unique path and its constraints, see unique_sol
+     */
+    void solve_unique(int first, int last, std::ostream &ofile);
+
+    /**
+     * @brief Finds the sources of the cycle searches that are worth trying
+     * @details A cycle through last enters it from one of its neighbors. The neighbors
+     * an automorphism fixing last and preserving the constraints maps to each other
+     * close the same cycles up to that automorphism, so only the smallest of each orbit
+     * is searched.
+     *
+     * @param last vertex closing the cycles
+     * @param map list of pairs of integers of the form (i, v) representing
+     * the condition "vertex v must be visited at instant i"
+     * @param diamonds list of pairs (u, v) of vertices that must be visited consecutively
+     * @param images set, for each source searched, to the elements of the group mapping
+     * it to the other neighbors of its orbit
+     * @return neighbors of last searched as sources
+     */
+    std::vector<int> cycle_sources(int last,
+                                   const std::vector< std::pair<int,int> >& map,
+                                   const std::vector< std::pair<int,int> >& diamonds,
+                                   std::vector< std::vector<Permutation> >& images);
+
+    /**
+     * @brief Creates a new SAT solver of the selected backend
+     */
+    std::unique_ptr<SatSolver> new_solver();
+
+    /**
+     * @brief Allocates a fresh propositional variable after the ones of the formula
+     * @return index of the new variable
+     */
+    int new_var();
+
+    std::vector<int> create_ban(std::vector<int> &orig_path);
+    void extend_sat(const std::vector<int> &clause);
     std::vector<int> create_cons(int n_vertices);
-    void recopy(int n_vars, int n_clauses);
-    void add_cons(std::vector<int>& orig_path, std::vector<int>& cons, int pos);
-    std::string diam_s(int u, int v, int n_vertices);
-    void write_min_cons(std::vector<int>& orig_path, std::vector<int>& cons, int num, std::ofstream &ofile);
-    void condition1(std::vector< std::vector<int> > &clauses);
-    void condition2(std::vector< std::vector<int> > &clauses);
-    void condition3(std::vector< std::vector<int> > &clauses);
-    void condition4(std::vector< std::vector<int> > &clauses);
-    void condition5(std::vector< std::vector<int> > &clauses);
-    void condition6(std::vector< std::vector<int> > &clauses,
+
+    /**
+     * @brief Adds every candidate constraint to the solver, each one guarded by its
+     * own activation literal
+     * @details Constraint i only holds when its activation literal is assumed, so a
+     * prefix of the constraints can be tested with a single call to solve
+     *
+     * @param orig_path path whose positions and diamonds the constraints fix
+     * @param cons candidate constraints as returned by create_cons
+     * @return activation literal of each constraint
+     */
+    std::vector<int> add_cons(std::vector<int>& orig_path, std::vector<int>& cons);
+    void add_diam(int u, int v, int n_vertices, int guard);
+
+    /**
+     * @brief Finds the shortest prefix of the constraints that makes the path unique,
+     * testing several prefix lengths at once
+     * @details Each worker of the pool owns a solver holding the same formula as the
+     * current one. Every round tests k lengths splitting [lo, hi] in k+1 parts, where
+     * k is the number of workers, so the answer is the lo of the sequential binary search.
+     *
+     * @param first origin of the path
+     * @param last destination of the path
+     * @param orig_path path made unique
+     * @param cons candidate constraints as returned by create_cons
+     * @param act activation literals returned by add_cons
+     * @return length minus one of the shortest prefix making the path unique
+     */
+    int probe_parallel(int first, int last, std::vector<int>& orig_path,
+                       std::vector<int>& cons, const std::vector<int>& act);
+
+    /**
+     * @brief Gives this graph the solving options of another one: encoding, seeds,
+     * portfolio, minimisation, kernel, decomposition, cache and parallelism
+     * @details The SAT backend and the stats are left as they are
+     */
+    void configure_like(const Graph& other);
+
+    /**
+     * @brief Builds a graph with the same options as this one, for a worker thread
+     *
+     * @param temp_files files of the external solver of the copy are added to it,
+     * to be removed by the caller
+     */
+    std::unique_ptr<Graph> worker_copy(std::vector<std::string>& temp_files);
+
+    /**
+     * @brief Same as above, for a graph given by its adjacence list
+     */
+    std::unique_ptr<Graph> worker_copy(const std::vector< std::vector<int> >& adj_list,
+                                       std::vector<std::string>& temp_files);
+
+    /**
+     * @brief Tests whether a hamiltonian path goes from source to target, on the formula
+     * with free endpoints
+     * @details The deduction rules are tried first, and the positions they fix are
+     * assumed along with the endpoints
+     *
+     * @param found set to the path found, or cleared
+     */
+    bool joins(int source, int target, std::vector<int>& found);
+
+    /**
+     * @brief Applies the deduction rules to some of the candidate constraints
+     *
+     * @param first origin of the path
+     * @param last destination of the path
+     * @param orig_path path whose positions and diamonds the constraints fix
+     * @param cons candidate constraints as returned by create_cons
+     * @param chosen indices in cons of the constraints applied
+     * @return outcome of Deduction::deduce
+     */
+    Deduced deduce_cons(int first, int last, const std::vector<int>& orig_path,
+                        const std::vector<int>& cons, const std::vector<int>& chosen);
+
+    /**
+     * @brief Tests whether the first num+1 constraints make the path unique
+     * @details The solver is only called when the deduction rules do not find the
+     * path, and then the positions they fix are assumed as well
+     *
+     * @param first origin of the path
+     * @param last destination of the path
+     * @param orig_path path made unique
+     * @param cons candidate constraints as returned by create_cons
+     * @param act activation literals returned by add_cons
+     * @param num index of the last constraint switched on
+     * @param deduced set to whether the deduction rules gave the answer, if not null
+     * @return true if the ban of the path is unsatisfiable under the constraints
+     */
+    bool prefix_unique(int first, int last, const std::vector<int>& orig_path,
+                       const std::vector<int>& cons, const std::vector<int>& act, int num,
+                       bool* deduced = nullptr);
+
+    /**
+     * @brief Removes constraints from a set that makes the path unique until removing
+     * any single one of them gives a second solution
+     * @details Deletion based: every constraint is tested once on the current solver,
+     * and when it can be removed, the constraints outside the final conflict of the
+     * solver are removed as well. A removal the deduction rules prove is made without
+     * calling the solver.
+     *
+     * @param first origin of the path
+     * @param last destination of the path
+     * @param orig_path path made unique
+     * @param cons candidate constraints as returned by create_cons
+     * @param act activation literals returned by add_cons
+     * @param num the set holds the constraints 0 to num
+     * @return irredundant subset of the constraints
+     */
+    std::vector<int> minimise_cons(int first, int last, const std::vector<int>& orig_path,
+                                   const std::vector<int>& cons, const std::vector<int>& act, int num);
+    void write_min_cons(std::vector<int>& orig_path, std::vector<int>& cons, int num, std::ostream &ofile);
+    void condition1(ClauseSink &sink);
+    void condition2(ClauseSink &sink, AmoEncoding amo);
+    void condition3(ClauseSink &sink);
+    void condition4(ClauseSink &sink, AmoEncoding amo);
+    void condition5(ClauseSink &sink);
+    void condition6(ClauseSink &sink,
         const std::vector< std::pair<int,int> >& map);
-    void condition7(std::vector< std::vector<int> > &clauses,
+    void condition7(ClauseSink &sink,
+        const std::vector< std::pair<int,int> >& diamonds);
+    void condition8(ClauseSink &sink);
+    void condition9(ClauseSink &sink);
+    void condition10(ClauseSink &sink);
+    void condition11(ClauseSink &sink, int source);
+    void condition12(ClauseSink &sink, int dest);
+    void condition13(ClauseSink &sink, int source);
+    void condition14(ClauseSink &sink, int dest);
+    void condition15(ClauseSink &sink, int source, int dest);
+    void condition16(ClauseSink &sink, int source, int dest,
+        const std::vector< std::pair<int,int> >& map,
         const std::vector< std::pair<int,int> >& diamonds);
-    void condition8(std::vector< std::vector<int> > &clauses);
-    void condition9(std::vector< std::vector<int> > &clauses);
-    void condition10(std::vector< std::vector<int> > &clauses);
-    void condition11(std::vector< std::vector<int> > &clauses, int source);
-    void condition12(std::vector< std::vector<int> > &clauses, int dest);
-    void condition13(std::vector< std::vector<int> > &clauses, int source);
-    void condition14(std::vector< std::vector<int> > &clauses, int dest);
-    void write_sat(std::vector<std::vector<int> > &clauses);
 
 public:
 
     /**
      * @brief Constructs SAT expression representing a hamiltonian path/cycle 
+     * @details With source or dest equal to -1 the endpoints are left free, to be
+     * assumed at each call to solve, and the families naming them are not added
      * 
      * @param solver SAT formula's object
      * @param map list of pairs of integers of the form (i, v) representing
      * the condition "vertex v must be visited at instant i"
      * @param diamonds list of diamonds in the form of a list of pairs of integers of the form (u, v) representing
      * the condition "vertex v and vertex u must be visited consecutively, in any order"
+     * @param options encodings used to build the formula
      */
     void construct_sat(int source, int dest,
                        const std::vector< std::pair<int,int> >& map = {},
-                       const std::vector< std::pair<int,int> >& diamonds = {});
+                       const std::vector< std::pair<int,int> >& diamonds = {},
+                       const EncodingOptions& options = EncodingOptions());
 
     /**
      * @brief Reads SAT's solution and generates the corresponding path
@@ -208,7 +598,143 @@ public:
      */
     std::vector<int>& read_sol();
 
-    void solve_sat();
+    /**
+     * @brief Solves the formula built by the last call to construct_sat
+     * @return true if the formula is satisfiable
+     */
+    bool solve_sat();
+
+    /**
+     * @brief Selects the SAT solver used by the next calls to construct_sat
+     *
+     * @param backend in-process solver or external binary
+     */
+    void set_sat_backend(SatBackend backend);
+
+    /**
+     * @brief Selects the external backend with a given binary and files
+     *
+     * @param solver_path path of the solver binary
+     * @param input_path file where the formula is written
+     * @param output_path file where the output of the solver is redirected
+     */
+    void set_external_solver(const std::string& solver_path,
+                             const std::string& input_path,
+                             const std::string& output_path);
+
+    /**
+     * @brief Keeps the files exchanged with the external solver in a directory
+     * @details By default they are next to the executable, so graphs of different
+     * threads or processes using the external backend need directories of their own
+     *
+     * @param dir existing directory
+     */
+    void set_workspace(const std::string& dir);
+
+    /**
+     * @brief Selects the seed of the embedded solvers built by the next calls to construct_sat
+     *
+     * @param seed 0 for the deterministic default
+     */
+    void set_sat_seed(unsigned seed);
+
+    /**
+     * @brief Makes unique_sol shuffle the candidate constraints with a fixed seed, so
+     * that the constraints it finds are reproducible
+     *
+     * @param seed seed of the shuffle
+     */
+    void set_shuffle_seed(unsigned seed);
+
+    /**
+     * @brief Makes the SAT solvers and the backtracking searches give up as soon as
+     * the flag is set, the flag may be set from another thread
+     *
+     * @param flag flag polled by the engines, or nullptr
+     */
+    void set_terminate(const std::atomic<bool>* flag);
+
+    /**
+     * @brief Selects whether unique_sol removes the redundant constraints of the
+     * puzzle it generates, which it does by default
+     */
+    void set_minimise(bool minimise);
+
+    /**
+     * @brief Returns the number of calls to the SAT solver made by the last minimisation
+     * of unique_sol, or -1 if its puzzle came from the cache
+     */
+    long long get_min_calls();
+
+    /**
+     * @brief Selects whether path queries without constraints are solved on the kernel
+     * of the graph (see Kernel), which they are by default
+     */
+    void set_kernelise(bool kernelise);
+
+    /**
+     * @brief Selects whether single path queries without constraints are split at the
+     * cut vertices and separators of two vertices of the graph (see Decomposition),
+     * which they are by default
+     */
+    void set_decompose(bool decompose);
+
+    /**
+     * @brief Returns the kernel of the last path query, or nullptr if none was built
+     */
+    const Kernel* get_kernel() const;
+
+    /**
+     * @brief Records the time of every phase, the size of every condition family and
+     * the probes of unique_sol in a Stats
+     * @details The stats are filled by the thread calling the methods of the graph.
+     * The graphs built internally for other threads are not measured, except for the
+     * time and the answer of each probe made by probe_parallel.
+     *
+     * @param stats where the measures are added, or nullptr to turn stats off
+     */
+    void set_stats(Stats* stats);
+
+    /**
+     * @brief Keeps the results of ham_path (without count), ham_path_portfolio,
+     * count_paths and unique_sol in a cache, and answers from it the queries it holds
+     * @details A query is the board, the endpoints, the constraints and the mode. Only
+     * definitive answers are stored, not those of engines cancelled by the terminate flag.
+     * Puzzles are only cached when the shuffle seed is fixed (see set_shuffle_seed), which
+     * is then part of the query, so that unseeded generation gives a new puzzle each time.
+     *
+     * @param cache where the results are kept, or nullptr to turn the cache off
+     */
+    void set_cache(ResultCache* cache);
+
+    /**
+     * @brief Makes unique_sol find its base path with ham_path_portfolio
+     *
+     * @param options engines raced
+     */
+    void set_portfolio(const PortfolioOptions& options);
+
+    /**
+     * @brief Selects the options used to build the formulas of ham_path, ham_cycle
+     * and unique_sol
+     *
+     * @param options encodings used to build the formula
+     */
+    void set_encoding_options(const EncodingOptions& options);
+
+    /**
+     * @brief Selects how the backtracking search counts paths and how unique_sol probes
+     * the constraints
+     * @details With more than one thread, the search tree is split at depth split_depth
+     * and the subtrees are searched in parallel. The paths found are the same, in the
+     * same order, as with a single thread. unique_sol tests n_threads sets of
+     * constraints at once, each one on its own solver.
+     *
+     * @param n_threads number of worker threads, 1 for a sequential search
+     * @param split_depth number of steps of the partial paths that become tasks
+     */
+    void set_parallelism(int n_threads, int split_depth);
+
     /**
      * @brief Reads graph structure from file 
      * @details The first line in the file must be the number of vertices.
@@ -216,9 +742,9 @@ public:
      * in the form of pairs of integers representing the vertices.
      * The list of edges must end with a -1
      * 
-     * @param file file from where to read the file
+     * @param file stream from where to read the graph
      */
-    explicit Graph(std::ifstream &file);
+    explicit Graph(std::istream &file);
 
     /**
      * @brief Reads graph from adjacence list
@@ -261,6 +787,92 @@ public:
                                               const std::vector< std::pair<int,int> >& map = {},
                                               const std::vector< std::pair<int,int> >& diamonds = {});
 
+    /**
+     * @brief Hands the hamiltonian paths of the graph to a function as they are found,
+     * without keeping them in memory
+     * @details Paths without constraints are searched on the kernel of the graph and
+     * lifted one by one
+     *
+     * @param source source of the hamiltonian paths
+     * @param last destination of the hamiltonian paths
+     * @param visitor function called for every path found, the search stops when it
+     * returns false
+     * @param sat whether to use a SAT solver or the backtracking search
+     * @param map list of pairs of integers of the form (i, v) representing
+     * the condition "vertex v must be visited at instant i"
+     * @param diamonds list of diamonds in the form of a list of pairs of integers of the form (u, v) representing
+     * the condition "vertex v and vertex u must be visited consecutively, in any order"
+     * @return number of paths found
+     */
+    long long for_each_path(int source,
+                            int last,
+                            const PathVisitor& visitor,
+                            bool sat=true,
+                            const std::vector< std::pair<int,int> >& map = {},
+                            const std::vector< std::pair<int,int> >& diamonds = {});
+
+    /**
+     * @brief Gives the hamiltonian paths of the graph one at a time, each one being only
+     * searched when it is asked for, see PathIterator and for_each_path
+     * @details The graph must not be used while the iterator is alive
+     *
+     * @param source source of the hamiltonian paths
+     * @param last destination of the hamiltonian paths
+     * @param sat whether to use a SAT solver or the backtracking search
+     * @param limit maximum number of paths given, or -1 for all of them
+     * @param map list of pairs of integers of the form (i, v) representing
+     * the condition "vertex v must be visited at instant i"
+     * @param diamonds list of diamonds in the form of a list of pairs of integers of the form (u, v) representing
+     * the condition "vertex v and vertex u must be visited consecutively, in any order"
+     * @return iterator over the paths, the search stops when it is destroyed
+     */
+    std::unique_ptr<PathIterator> iterate_paths(int source,
+                                                int last,
+                                                bool sat=true,
+                                                long long limit=-1,
+                                                const std::vector< std::pair<int,int> >& map = {},
+                                                const std::vector< std::pair<int,int> >& diamonds = {});
+
+    /**
+     * @brief Counts the hamiltonian paths of the graph without keeping them in memory
+     * @details The frontier dynamic program is used when it can express the constraints,
+     * see FrontierCounter, otherwise the paths are enumerated by the backtracking search
+     *
+     * @param source source of the hamiltonian paths
+     * @param last destination of the hamiltonian paths
+     * @param map list of pairs of integers of the form (i, v) representing
+     * the condition "vertex v must be visited at instant i"
+     * @param diamonds list of diamonds in the form of a list of pairs of integers of the form (u, v) representing
+     * the condition "vertex v and vertex u must be visited consecutively, in any order"
+     * @return number of paths, saturated at LLONG_MAX
+     */
+    long long count_paths(int source,
+                          int last,
+                          const std::vector< std::pair<int,int> >& map = {},
+                          const std::vector< std::pair<int,int> >& diamonds = {});
+
+    /**
+     * @brief Finds a hamiltonian path by racing several engines
+     * @details The backtracking search and the SAT solvers run in their own threads on
+     * copies of the graph. The first engine to answer, with a path or with a proof that
+     * there is none, wins and the others are cancelled: external solver processes are
+     * killed and their temporary files removed.
+     *
+     * @param source source of the hamiltonian path
+     * @param last destination of the hamiltonian path
+     * @param options engines raced
+     * @param map list of pairs of integers of the form (i, v) representing
+     * the condition "vertex v must be visited at instant i"
+     * @param diamonds list of diamonds in the form of a list of pairs of integers of the form (u, v) representing
+     * the condition "vertex v and vertex u must be visited consecutively, in any order"
+     * @return list with the path found, empty if there is none
+     */
+    std::vector< std::vector<int> >& ham_path_portfolio(int source,
+                                                        int last,
+                                                        const PortfolioOptions& options,
+                                                        const std::vector< std::pair<int,int> >& map = {},
+                                                        const std::vector< std::pair<int,int> >& diamonds = {});
+
     /**
      * @brief Finds existing hamiltonian cycles in the graph
      * @details The user can specify the method used internally to find hamiltonian cycles.
@@ -276,26 +888,57 @@ public:
                                                const std::vector< std::pair<int,int> >& map = {},
                                                const std::vector< std::pair<int,int> >& diamonds = {});
     /**
-     * @brief Returns all up to k hamiltonian paths from source to last in the graph
-     * 
-     * @param k maximum number of hamiltonian paths to be returned
+     * @brief Tells whether there are at most k hamiltonian paths from source to last
+     * @details The paths are pulled from iterate_paths, so at most k + 1 of them are
+     * searched
+     *
+     * @param k maximum number of hamiltonian paths
      * @param source source of the hamiltonian paths
      * @param last destination of the hamiltonian paths
      * @param map list of pairs of integers of the form (i, v) representing
      * the condition "vertex v must be visited at instant i"
      * @param diamonds list of diamonds in the form of a list of pairs of integers of the form (u, v) representing
      * the condition "vertex v and vertex u must be visited consecutively, in any order"
-     * @return a list of all the distinct hamiltonian paths from the source to the last vertex considering
-     * the constraints imposed by the maps and the diamonds. If more than k paths exist, only the first
-     * k paths found will be returned
+     * @return the first path found if there are at most k paths, an empty path if there
+     * are more or none
      */
     std::vector<int>& k_paths(int k,
-                                              int source,
-                                              int last,
-                                              const std::vector< std::pair<int, int> >& map,
-                                              const std::vector< std::pair<int, int> >& diamonds);
+                              int source,
+                              int last,
+                              const std::vector< std::pair<int, int> >& map,
+                              const std::vector< std::pair<int, int> >& diamonds);
+
+    void unique_sol(int first, int last, std::ostream &ofile);
+
+    /**
+     * @brief Finds the pairs of vertices joined by a hamiltonian path
+     * @details The pairs ruled out by EndpointFilter are not searched. The others are
+     * tested on a single formula with free endpoints, assumed for each pair, by
+     * n_threads workers each holding a copy of the formula. Pairs that an automorphism
+     * of the graph, or the reversal of the path on undirected graphs, maps to each other
+     * are tested once. On undirected graphs every path found is rotated (an endpoint
+     * adjacent to an inner vertex gives a path ending next to it) and the pairs reached
+     * that way are not tested.
+     *
+     * @return matrix whose entry [s][t] is 1 if a hamiltonian path goes from s to t
+     */
+    std::vector< std::vector<char> > feasible_pairs();
 
-    void unique_sol(int first, int last, std::ofstream &ofile);
+    /**
+     * @brief Measures the impact of each redundant clause family on the time needed
+     * to find a hamiltonian path
+     * @details Every family of condition8 to condition16 is switched, one at a time,
+     * from its state in the current encoding options and the path is searched again.
+     * One line per family is written with its clause count, the mean time spent building
+     * the formula and the mean time spent solving it, the change being that of the
+     * solve time. Each trial gives the solver a seed of its own, from the current one on.
+     *
+     * @param source source of the hamiltonian path
+     * @param dest destination of the hamiltonian path
+     * @param trials number of runs averaged for each configuration
+     * @param out stream where the report is written
+     */
+    void ablation(int source, int dest, int trials, std::ostream &out);
 };
 
 #endif //RIKUDOSOLVER_GRAPH_H
@@ -0,0 +1,232 @@
+//
+// Created by:
+//    Cauim de S. Lima - cauimsouza@gmail.com
+//    Victor Hugo Vianna Silva - victor.vianna10@gmail.com
+//
+
+#include "kernel.h"
+#include "endpoint_filter.h"
+#include <algorithm>
+
+
+Kernel::Kernel(const std::vector< std::vector<int> >& adj_list, int source, int target)
+    : n_vertices(adj_list.size()), source(source), target(target), infeasible(false),
+      removed_vertices(0), removed_edges(0)
+{
+    neighbors.assign(n_vertices, std::set<int>());
+    for(int u = 0; u < n_vertices; u++)
+        for(int v : adj_list[u])
+            if(v != u)  neighbors[u].insert(v);
+
+    bool symmetric = true;
+    int n_edges = 0;
+    for(int u = 0; u < n_vertices; u++)
+        for(int v : neighbors[u]){
+            if(!neighbors[v].count(u))  symmetric = false;
+            if(u < v)   n_edges++;
+        }
+
+    bool valid = source >= 0 && source < n_vertices && target >= 0 && target < n_vertices;
+    if(symmetric && valid && source != target && n_vertices > 2){
+        forced.assign(n_vertices, std::vector<int>());
+        parent.resize(n_vertices);
+        size.assign(n_vertices, 1);
+        for(int v = 0; v < n_vertices; v++)
+            parent[v] = v;
+        entry.assign(n_vertices, -1);
+        hidden.assign(n_vertices, std::vector<int>());
+
+        reduce();
+        if(!infeasible){
+            std::vector< std::vector<int> > left(n_vertices);
+            for(int v = 0; v < n_vertices; v++)
+                left[v].assign(neighbors[v].begin(), neighbors[v].end());
+            if(!EndpointFilter(left).may_join(source, target))
+                infeasible = true;
+        }
+        if(!infeasible) contract();
+    }
+    else{
+        // the graph is kept as it is
+        kernel_adj = adj_list;
+        for(int v = 0; v < n_vertices; v++){
+            original.push_back(v);
+            renamed.push_back(v);
+        }
+        return;
+    }
+
+    renamed.assign(n_vertices, -1);
+    if(infeasible){
+        removed_vertices = n_vertices;
+        removed_edges = n_edges;
+        return;
+    }
+
+    for(int v = 0; v < n_vertices; v++)
+        if(!neighbors[v].empty() || v == source || v == target){
+            renamed[v] = original.size();
+            original.push_back(v);
+        }
+    kernel_adj.assign(original.size(), std::vector<int>());
+    int kept_edges = 0;
+    for(int v : original)
+        for(int w : neighbors[v]){
+            kernel_adj[renamed[v]].push_back(renamed[w]);
+            if(v < w)   kept_edges++;
+        }
+    removed_vertices = n_vertices - original.size();
+    removed_edges = n_edges - kept_edges;
+}
+
+int Kernel::find(int v)
+{
+    while(parent[v] != v){
+        parent[v] = parent[parent[v]];
+        v = parent[v];
+    }
+    return v;
+}
+
+bool Kernel::is_forced(int u, int v) const
+{
+    return std::find(forced[u].begin(), forced[u].end(), v) != forced[u].end();
+}
+
+void Kernel::force(int u, int v)
+{
+    int a = find(u), b = find(v);
+    if(a == b){
+        // the forced edges would close a cycle
+        infeasible = true;
+        return;
+    }
+    forced[u].push_back(v);
+    forced[v].push_back(u);
+    if(size[a] < size[b])   std::swap(a, b);
+    parent[b] = a;
+    size[a] += size[b];
+
+    if(find(source) == find(target) && size[find(source)] < n_vertices)
+        infeasible = true;
+}
+
+void Kernel::remove(int u, int v)
+{
+    neighbors[u].erase(v);
+    neighbors[v].erase(u);
+}
+
+void Kernel::reduce()
+{
+    bool changed = true;
+    while(changed && !infeasible){
+        changed = false;
+        for(int v = 0; v < n_vertices && !infeasible; v++){
+            int needed = (v == source || v == target) ? 1 : 2;
+            if((int) neighbors[v].size() < needed || (int) forced[v].size() > needed){
+                infeasible = true;
+                break;
+            }
+
+            // the edges left are all in the path
+            if((int) neighbors[v].size() == needed && (int) forced[v].size() < needed){
+                for(int w : std::vector<int>(neighbors[v].begin(), neighbors[v].end()))
+                    if(!is_forced(v, w) && !infeasible) force(v, w);
+                changed = true;
+            }
+
+            // the path already has all the edges of v
+            if((int) forced[v].size() == needed && (int) neighbors[v].size() > needed){
+                for(int w : std::vector<int>(neighbors[v].begin(), neighbors[v].end()))
+                    if(!is_forced(v, w))    remove(v, w);
+                changed = true;
+            }
+        }
+
+        // edges closing a cycle of fragments, or joining the fragments of the endpoints
+        // while others are left
+        for(int u = 0; u < n_vertices && !infeasible; u++)
+            for(int v : std::vector<int>(neighbors[u].begin(), neighbors[u].end())){
+                if(v < u || is_forced(u, v))    continue;
+                int a = find(u), b = find(v);
+                bool ends = (a == find(source) && b == find(target)) ||
+                            (a == find(target) && b == find(source));
+                if(a == b || (ends && size[a] + size[b] < n_vertices)){
+                    remove(u, v);
+                    changed = true;
+                }
+            }
+    }
+}
+
+void Kernel::contract()
+{
+    auto inner = [this](int v){
+        return v != source && v != target && neighbors[v].size() == 2;
+    };
+
+    std::vector<bool> seen(n_vertices, false);
+    for(int v = 0; v < n_vertices && !infeasible; v++){
+        if(seen[v] || !inner(v))    continue;
+
+        // walks both ways from v to the ends of its chain
+        std::vector<int> side[2];
+        int end[2];
+        seen[v] = true;
+        for(int d = 0; d < 2; d++){
+            int prev = v;
+            int cur = d == 0 ? *neighbors[v].begin() : *neighbors[v].rbegin();
+            while(inner(cur) && !seen[cur]){
+                seen[cur] = true;
+                side[d].push_back(cur);
+                int next = *neighbors[cur].begin() == prev ? *neighbors[cur].rbegin() : *neighbors[cur].begin();
+                prev = cur;
+                cur = next;
+            }
+            end[d] = cur;
+        }
+
+        // a chain hanging from a single vertex can be entered but not left
+        if(end[0] == end[1] || inner(end[0])){
+            infeasible = true;
+            return;
+        }
+
+        std::vector<int> chain(side[0].rbegin(), side[0].rend());
+        chain.push_back(v);
+        chain.insert(chain.end(), side[1].begin(), side[1].end());
+        if(chain.size() < 2)    continue;
+
+        // chain[0] takes the place of the whole chain
+        int keep = chain[0];
+        remove(chain[0], chain[1]);
+        remove(chain.back(), end[1]);
+        for(int i = 1; i + 1 < (int) chain.size(); i++)
+            remove(chain[i], chain[i + 1]);
+        neighbors[keep].insert(end[1]);
+        neighbors[end[1]].insert(keep);
+        entry[keep] = end[0];
+        hidden[keep].assign(chain.begin() + 1, chain.end());
+    }
+}
+
+std::vector<int> Kernel::lift(const std::vector<int>& path) const
+{
+    std::vector<int> lifted;
+    for(int i = 0; i < (int) path.size(); i++){
+        int v = original[path[i]];
+        if(hidden.empty() || hidden[v].empty()){
+            lifted.push_back(v);
+        }
+        else if(i > 0 && original[path[i - 1]] == entry[v]){
+            lifted.push_back(v);
+            lifted.insert(lifted.end(), hidden[v].begin(), hidden[v].end());
+        }
+        else{
+            lifted.insert(lifted.end(), hidden[v].rbegin(), hidden[v].rend());
+            lifted.push_back(v);
+        }
+    }
+    return lifted;
+}
@@ -0,0 +1,115 @@
+//
+// Created by:
+//    Cauim de S. Lima - cauimsouza@gmail.com
+//    Victor Hugo Vianna Silva - victor.vianna10@gmail.com
+//
+
+#ifndef RIKUDOSOLVER_KERNEL_H
+#define RIKUDOSOLVER_KERNEL_H
+
+#include <set>
+#include <vector>
+
+/**
+ * @brief Smaller graph having the same hamiltonian paths between two endpoints as a
+ * given one, up to a mapping of the vertices
+ * @details On undirected graphs, repeated to a fixpoint:
+ * - an inner vertex of the path has two edges in it and an endpoint one, so a vertex
+ * with only that many edges left has all of them forced, and a vertex with that many
+ * forced edges loses the others,
+ * - forced edges closing a cycle, or joining the endpoints before every vertex is
+ * covered, make the instance impossible; an edge that would do so is removed.
+ * The graph left is then checked by EndpointFilter (connectivity, cut vertices and
+ * bridges, vertices of degree one, independent sets). Finally every chain of inner
+ * vertices of degree two, which a path crosses from end to end, is contracted to a
+ * single vertex. A path of the kernel is lifted back by expanding those vertices in
+ * the direction the path crosses them.
+ * Directed graphs are kept as they are.
+ */
+class Kernel
+{
+private:
+    int n_vertices;
+    int source;
+    int target;
+    bool infeasible;
+
+    /**
+     * neighbors of every vertex and forced edges, while reducing
+     */
+    std::vector< std::set<int> > neighbors;
+    std::vector< std::vector<int> > forced;
+
+    /**
+     * union-find over the forced edges, whose sets are the fragments of the path
+     */
+    std::vector<int> parent;
+    std::vector<int> size;
+
+    /**
+     * adjacency lists of the kernel, vertex of the graph of each vertex of the kernel
+     * and number of the kernel vertex of each vertex of the graph, or -1
+     */
+    std::vector< std::vector<int> > kernel_adj;
+    std::vector<int> original;
+    std::vector<int> renamed;
+
+    /**
+     * for the vertex keeping a contracted chain, the neighbor on its side and the
+     * other vertices of the chain in order from it
+     */
+    std::vector<int> entry;
+    std::vector< std::vector<int> > hidden;
+
+    int removed_vertices;
+    int removed_edges;
+
+    int find(int v);
+    bool is_forced(int u, int v) const;
+    void force(int u, int v);
+    void remove(int u, int v);
+    void reduce();
+    void contract();
+
+public:
+    /**
+     * @param adj_list adjacence list of the graph
+     * @param source origin of the paths
+     * @param target destination of the paths
+     */
+    Kernel(const std::vector< std::vector<int> >& adj_list, int source, int target);
+
+    /**
+     * @return true if no hamiltonian path goes from source to target
+     */
+    bool is_infeasible() const { return infeasible; }
+
+    /**
+     * @return true if the kernel is the graph itself
+     */
+    bool is_trivial() const { return removed_vertices == 0 && removed_edges == 0; }
+
+    /**
+     * @return adjacence list of the kernel, empty if it is infeasible
+     */
+    const std::vector< std::vector<int> >& get_adj_list() const { return kernel_adj; }
+
+    /**
+     * @return endpoints of the paths in the kernel
+     */
+    int get_source() const { return renamed[source]; }
+    int get_target() const { return renamed[target]; }
+
+    /**
+     * @return number of vertices and of undirected edges the kernel has less than the graph
+     */
+    int get_removed_vertices() const { return removed_vertices; }
+    int get_removed_edges() const { return removed_edges; }
+
+    /**
+     * @brief Maps a hamiltonian path of the kernel to one of the graph
+     */
+    std::vector<int> lift(const std::vector<int>& path) const;
+};
+
+#endif //RIKUDOSOLVER_KERNEL_H
@@ -9,40 +9,144 @@
 #include <cstring>
 #include <cstdlib>
 #include <string>
+#include <sstream>
 #include <ctime>
 #include <climits>
+#include <mutex>
+#include <cstdio>
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <dirent.h>
+#include <unistd.h>
 #include "graph.h"
+#include "thread_pool.h"
+#include "stats.h"
+#include "board_file.h"
+#include "result_cache.h"
 
 /**
- * @brief Count the number of hamiltonian paths between two opposite corners of a squared grid
- * 
- * @param n size of the squared grid
+ * Options given in the command line
+ */
+struct Settings
+{
+    SatBackend backend;
+    EncodingOptions options;
+    int n_threads;
+    int split_depth;
+    bool use_portfolio;
+    PortfolioOptions portfolio;
+    bool minimise;
+    bool kernelise;
+    bool decompose;
+    bool verbose;
+    bool stats;
+    std::string stats_file;
+    ResultCache* cache;
+
+    Settings() : backend(SatBackend::EMBEDDED), n_threads(1), split_depth(8), use_portfolio(false),
+                 minimise(true), kernelise(true), decompose(true), verbose(false), stats(false), cache(nullptr) {}
+};
+
+/**
+ * @brief Applies the command line options to a graph
+ */
+void configure(Graph& graph, const Settings& settings)
+{
+    graph.set_sat_backend(settings.backend);
+    graph.set_encoding_options(settings.options);
+    graph.set_parallelism(settings.n_threads, settings.split_depth);
+    if(settings.use_portfolio)  graph.set_portfolio(settings.portfolio);
+    graph.set_minimise(settings.minimise);
+    graph.set_kernelise(settings.kernelise);
+    graph.set_decompose(settings.decompose);
+    graph.set_cache(settings.cache);
+}
+
+/**
+ * @brief Writes the stats of a run as a single JSON line, appended to the file given
+ * with --stats=FILE or to stderr, and stops measuring the graph
+ *
+ * @param stats measures of the run
+ * @param mode what was asked: unique, path or count
+ * @param input file of the board, if any
+ * @param graph graph of the run
+ * @param settings options given in the command line
  */
-void count_path_between_corners(int n){
-    if(n <= 2){
-        std::cout << n << std::endl;
+void write_stats(Stats& stats, const std::string& mode, const std::string& input,
+                 Graph& graph, const Settings& settings)
+{
+    graph.set_stats(nullptr);
+    stats.set_label("mode", mode);
+    if(!input.empty())  stats.set_label("input", input);
+    stats.add("vertices", graph.get_adj_list().size());
+    if(mode == "unique" && settings.minimise && graph.get_min_calls() >= 0)
+        stats.add("min_calls", graph.get_min_calls());
+
+    if(settings.stats_file.empty()){
+        stats.write_json(std::cerr);
         return;
     }
+    std::ofstream out(settings.stats_file, std::ios::app);
+    stats.write_json(out);
+}
 
-    std::vector<std::vector<int>> adj_list(n*n, std::vector<int>());
+/**
+ * @brief Tells on stderr, with --verbose, how much the kernel of the last path query
+ * of a graph removed
+ */
+void report_kernel(Graph& graph, const Settings& settings)
+{
+    const Kernel* kernel = graph.get_kernel();
+    if(!settings.verbose || !kernel)    return;
+    if(kernel->is_infeasible())
+        std::cerr << "kernel: no hamiltonian path\n";
+    else
+        std::cerr << "kernel: removed " << kernel->get_removed_vertices() << " vertices and "
+                  << kernel->get_removed_edges() << " edges\n";
+}
 
-    int di[] = {1,0,-1,0};
-    int dj[] = {0,1,0,-1};
-    for(int i = 0; i < n; i++)
-        for(int j = 0; j < n; j++)
-            for(int k = 0; k < 4; k++) {
-                int ii = i + di[k];
-                int jj = j + dj[k];
-                if (ii >= 0 && ii < n && jj >= 0 && jj < n)
-                    adj_list[ i*n+j ].push_back( ii*n+jj );
-            }
+/**
+ * A board read from a file, with the endpoints of its paths and the constraints stored
+ * in a binary board
+ */
+struct Board
+{
+    std::unique_ptr<Graph> graph;
+    int source;
+    int target;
+    std::vector< std::pair<int,int> > map;
+    std::vector< std::pair<int,int> > diamonds;
+};
 
-    Graph graph(adj_list);
-    auto paths = graph.ham_path(0, n*n-1);
-    printf("Number of paths: %d\n", (int) paths.size());
+/**
+ * @brief Reads a board in the text format described in solves_rikudo, followed by the
+ * source and the target, or in the binary format written by --convert
+ *
+ * @param file_name file of the board
+ * @param settings options given in the command line, applied to the graph
+ */
+Board load_board(const std::string& file_name, const Settings& settings)
+{
+    Board board;
+    if(BoardFile::is_board_file(file_name)){
+        BoardFile file(file_name);
+        board.graph.reset(new Graph(file.adj_list()));
+        board.source = file.source();
+        board.target = file.target();
+        board.map = file.map();
+        board.diamonds = file.diamonds();
+    }
+    else{
+        std::ifstream ifile(file_name);
+        if(!ifile)  throw "Unable to open input file";
+        board.graph.reset(new Graph(ifile));
+        ifile >> board.source >> board.target;
+    }
+    configure(*board.graph, settings);
+    return board;
 }
 
-
 /**
  * @brief Reads a description of a graph from an input file and finds contraints so that
  * an unique hamiltonian path from a source to an origin exists and writes this path
@@ -73,67 +177,536 @@ void count_path_between_corners(int n){
  * -1 <-marks the end of the list of diamond conditions
  * ----output.txt---
  * 
- * @param ifile input file from where to read the description of the graph
+ * The input may also be a binary board written by --convert.
+ *
+ * @param input input file from where to read the description of the graph
  * as well as the source and the origin of the desired hamiltonian path
  * @param ofile output file where to write the unique hamiltonian path and
  * the conditions imposed to this graph that make this path unique. 
+ * @param settings options given in the command line
  */
-void solves_rikudo(std::ifstream &ifile, std::ofstream &ofile)
+void solves_rikudo(const std::string& input, std::ofstream &ofile, const Settings& settings)
 {
-    Graph graph(ifile);
+    Board board = load_board(input, settings);
+    Graph& graph = *board.graph;
+    Stats stats;
+    if(settings.stats)  graph.set_stats(&stats);
+
+    int begin = board.source;
+    int end = board.target;
 
-    int begin, end;
-    ifile >> begin >> end;
+    {
+        PhaseTimer timer(settings.stats ? &stats : nullptr, "total");
+        graph.unique_sol(begin, end, ofile);
+    }
 
-    graph.unique_sol(begin, end, ofile);
+    report_kernel(graph, settings);
+    if(settings.verbose && settings.minimise && graph.get_min_calls() >= 0)
+        std::cerr << "minimisation: " << graph.get_min_calls() << " solver calls\n";
+    if(settings.stats)  write_stats(stats, "unique", "", graph, settings);
 }
 
-int main(int argc, char const *argv[])
+/**
+ * @brief Removes a directory and the files in it
+ */
+void remove_workspace(const std::string& dir)
+{
+    DIR* d = opendir(dir.c_str());
+    if(d){
+        while(dirent* entry = readdir(d)){
+            std::string name(entry->d_name);
+            if(name != "." && name != "..")
+                std::remove((dir + "/" + name).c_str());
+        }
+        closedir(d);
+    }
+    rmdir(dir.c_str());
+}
+
+/**
+ * @brief Generates puzzles for a list of boards in parallel
+ * @details Every line of the list holds the input file of a board, in the format read
+ * by solves_rikudo, and the output file where its solution is written, which is left
+ * alone when the job fails. Every job has a graph and a solver of its own, and the
+ * threads of --threads are divided between the jobs. With the external backend, the files of the solver of
+ * a job are kept in a private temporary directory, removed when the job ends, so jobs
+ * never share them.
+ *
+ * @param list stream with one pair of file names per line
+ * @param n_jobs number of jobs run at the same time
+ * @param settings options given in the command line
+ * @param out stream where a line with "ok" or the error is written for every job,
+ * in the order of the list
+ *
+ * The stats of the jobs, if asked, are written as they finish.
+ */
+void generate_batch(std::istream& list, int n_jobs, const Settings& settings, std::ostream& out)
+{
+    std::vector< std::pair<std::string, std::string> > jobs;
+    std::string input, output;
+    while(list >> input >> output)
+        jobs.push_back(std::make_pair(input, output));
+
+    // the threads asked for are shared by the jobs running at the same time
+    Settings job_settings = settings;
+    job_settings.n_threads = std::max(1, settings.n_threads / n_jobs);
+
+    std::vector<std::string> status(jobs.size());
+    std::mutex stats_mutex;
+    ThreadPool pool(n_jobs);
+    for(int j = 0; j < (int) jobs.size(); j++){
+        pool.submit([&, j](int){
+            std::string workspace;
+            try{
+                Board board = load_board(jobs[j].first, job_settings);
+                Graph& graph = *board.graph;
+
+                if(settings.backend == SatBackend::EXTERNAL){
+                    char dir[] = "/tmp/rikudo_XXXXXX";
+                    if(!mkdtemp(dir))   throw "Unable to create a workspace";
+                    workspace = dir;
+                    graph.set_workspace(workspace);
+                }
+
+                Stats stats;
+                if(settings.stats)  graph.set_stats(&stats);
+
+                // the output file is only written once the puzzle is solved
+                std::ostringstream solution;
+                {
+                    PhaseTimer timer(settings.stats ? &stats : nullptr, "total");
+                    graph.unique_sol(board.source, board.target, solution);
+                }
+                std::ofstream ofile(jobs[j].second);
+                if(!(ofile << solution.str()))  throw "Unable to write output file";
+                status[j] = "ok";
+
+                if(settings.stats){
+                    std::lock_guard<std::mutex> lock(stats_mutex);
+                    write_stats(stats, "unique", jobs[j].first, graph, job_settings);
+                }
+            }
+            catch(const char* message){
+                status[j] = std::string("error ") + message;
+            }
+            catch(const std::exception& e){
+                status[j] = std::string("error ") + e.what();
+            }
+            catch(...){
+                status[j] = "error unknown";
+            }
+            if(!workspace.empty())  remove_workspace(workspace);
+        });
+    }
+    pool.wait();
+
+    for(int j = 0; j < (int) jobs.size(); j++)
+        out << jobs[j].first << " " << status[j] << "\n";
+}
+
+/**
+ * @brief Writes a hamiltonian path of the graph in a single line, or an empty line
+ * if there is none
+ */
+void write_path(Graph& graph, int source, int target, const Settings& settings, std::ostream& out,
+                const std::vector< std::pair<int,int> >& map = {},
+                const std::vector< std::pair<int,int> >& diamonds = {})
+{
+    auto paths = settings.use_portfolio ? graph.ham_path_portfolio(source, target, settings.portfolio, map, diamonds)
+                                        : graph.ham_path(source, target, true, false, map, diamonds);
+    if(paths.size() > 0){
+        for(int i : paths[0])
+            out << i << " ";
+    }
+    out << "\n";
+}
+
+/**
+ * @brief Writes the pairs of vertices joined by a hamiltonian path: the number of
+ * vertices, then one line per source with a 1 for each target it is joined to and a 0
+ * otherwise
+ */
+void write_pairs(Graph& graph, std::ostream& out)
 {
-    if(argc == 1){
-        std::ifstream ifile("graph.txt");
-        std::ofstream ofile("solution.txt");
+    auto feasible = graph.feasible_pairs();
+    out << feasible.size() << "\n";
+    for(auto& row : feasible){
+        for(char joined : row)
+            out << (joined ? '1' : '0');
+        out << "\n";
+    }
+}
 
-        solves_rikudo(ifile, ofile);
+/**
+ * @brief Skips what is left of a request that could not be read, so that the next
+ * one starts where it should
+ *
+ * @param board whether the error came up in the board, the rest of which is skipped up
+ * to its -1 terminator together with the line of the endpoints
+ */
+void skip_request(std::istream& in, bool board)
+{
+    in.clear();
+    std::string line;
+    std::getline(in, line);
+    if(!board)  return;
 
-        ifile.close();
-        ofile.close();
+    while(std::getline(in, line)){
+        std::istringstream iss(line);
+        int value;
+        if(iss >> value && value < 0)   break;
     }
-    else if(argc == 2){
-        std::string ifile_name(argv[1]);
-        std::ifstream ifile(ifile_name);
-        Graph graph(ifile);
-        int source, target;
-        ifile >> source >> target;
-        auto paths = graph.ham_path(source, target);
-        if(paths.size() > 0){
-            for(int i : paths[0])
-                std::cout << i << " ";
-            std::cout << "\n";
+    std::getline(in, line);
+}
+
+/**
+ * @brief Answers the requests read from a stream until it ends or a quit request
+ * @details A request is a mode followed by a graph in the format of the input file
+ * of solves_rikudo, source and target included:
+ * ----request----
+ * unique <- unique, path, count, pairs or quit
+ * 4 <- number of vertices
+ * 0 1 <-oriented edge in the graph
+ * ...
+ * -1 <- marks the end of the edges
+ * 0 3 <- source and target
+ * ----request----
+ * The response is the content of the output file of solves_rikudo for unique, a path
+ * in a single line for path, the number of paths for count or the matrix of write_pairs
+ * for pairs, which ignores the source and the target, or a line "error" followed
+ * by the reason, and it always ends with a line "done". The rest of a request that
+ * cannot be read is skipped, up to the line of its endpoints.
+ * The last graph is kept between requests, so asking again about the same board reuses
+ * its search engine, counter, symmetries, kernel and thread pool instead of building
+ * them again; the SAT formula and its solver are built for every request.
+ *
+ * @param in stream of requests
+ * @param out stream of responses, flushed after each one
+ * @param settings options given in the command line
+ */
+void serve(std::istream& in, std::ostream& out, const Settings& settings)
+{
+    std::unique_ptr<Graph> graph;
+    std::string mode;
+    while(in >> mode && mode != "quit"){
+        // part of the request read: none, the board, the whole request
+        int read = 0;
+        std::string error;
+        try{
+            Graph request(in);
+            if(!in) throw "Invalid board";
+            read = 1;
+            int source = -1, target = -1;
+            in >> source >> target;
+            if(!in) throw "Invalid source or target";
+            read = 2;
+            int n_vertices = request.get_adj_list().size();
+            if(mode != "pairs" &&
+               (source < 0 || source >= n_vertices || target < 0 || target >= n_vertices))
+                throw "Invalid source or target";
+
+            if(!graph || graph->get_adj_list() != request.get_adj_list()){
+                graph.reset(new Graph(request.get_adj_list()));
+                configure(*graph, settings);
+            }
+            Stats stats;
+            if(settings.stats)  graph->set_stats(&stats);
+
+            {
+                PhaseTimer timer(settings.stats ? &stats : nullptr, "total");
+                if(mode == "unique"){
+                    graph->unique_sol(source, target, out);
+                    if(settings.verbose && settings.minimise && graph->get_min_calls() >= 0)
+                        std::cerr << "minimisation: " << graph->get_min_calls() << " solver calls\n";
+                }
+                else if(mode == "path"){
+                    write_path(*graph, source, target, settings, out);
+                }
+                else if(mode == "count"){
+                    out << graph->count_paths(source, target) << "\n";
+                }
+                else if(mode == "pairs"){
+                    write_pairs(*graph, out);
+                }
+                else{
+                    throw "Unknown mode";
+                }
+            }
+
+            if(settings.stats)  write_stats(stats, mode, "", *graph, settings);
+        }
+        catch(const char* message){
+            error = message;
         }
+        catch(const std::exception& e){
+            error = e.what();
+        }
+        catch(...){
+            error = "unknown";
+        }
+        if(!error.empty()){
+            if(graph)   graph->set_stats(nullptr);
+            out << "error " << error << "\n";
+            if(read < 2 && !in.eof())   skip_request(in, read == 0);
+        }
+        out << "done" << std::endl;
+
+        // the input ended in the middle of a request
+        if(!in) break;
     }
-    else if(argc == 3){
-        std::ifstream ifile;
-        std::ofstream ofile;
+}
 
-        std::string inp_file(argv[1]);
-        std::string out_file(argv[2]);
-        ifile.open(get_path(inp_file));
-        if(!ifile){
-            std::cerr << "Unable to open input file " << argv[1] << "\n";
-            exit(1);
+int main(int argc, char const *argv[])
+{
+    // options start with "--", the remaining arguments are file names
+    Settings settings;
+    bool ablation = false;
+    bool count = false;
+    bool daemon = false;
+    bool batch = false;
+    bool convert = false;
+    bool pairs = false;
+    bool list = false;
+    std::string cache_file;
+    int n_jobs = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::string> args;
+    for(int i = 1; i < argc; i++){
+        std::string arg(argv[i]);
+        if(arg == "--external-sat"){
+            settings.backend = SatBackend::EXTERNAL;
+        }
+        else if(arg == "--ablation"){
+            ablation = true;
+        }
+        else if(arg == "--count"){
+            count = true;
+        }
+        else if(arg == "--daemon"){
+            daemon = true;
+        }
+        else if(arg == "--batch"){
+            batch = true;
+        }
+        else if(arg == "--convert"){
+            convert = true;
+        }
+        else if(arg == "--pairs"){
+            pairs = true;
+        }
+        else if(arg == "--list"){
+            list = true;
+        }
+        else if(arg.compare(0, 7, "--jobs=") == 0){
+            n_jobs = std::max(1, atoi(arg.substr(7).c_str()));
+        }
+        else if(arg == "--no-minimise"){
+            settings.minimise = false;
+        }
+        else if(arg == "--no-kernel"){
+            settings.kernelise = false;
+        }
+        else if(arg == "--no-decompose"){
+            settings.decompose = false;
+        }
+        else if(arg == "--verbose"){
+            settings.verbose = true;
+        }
+        else if(arg == "--stats"){
+            settings.stats = true;
+        }
+        else if(arg.compare(0, 8, "--stats=") == 0){
+            // one line per run is appended to the file
+            settings.stats = true;
+            settings.stats_file = arg.substr(8);
+        }
+        else if(arg.compare(0, 8, "--cache=") == 0){
+            // results kept between runs
+            cache_file = arg.substr(8);
+        }
+        else if(arg == "--portfolio"){
+            settings.use_portfolio = true;
+        }
+        else if(arg.compare(0, 8, "--seeds=") == 0){
+            settings.portfolio.n_seeds = atoi(arg.substr(8).c_str());
+        }
+        else if(arg.compare(0, 9, "--solver=") == 0){
+            // external solver raced in the portfolio, may be repeated
+            settings.portfolio.external_solvers.push_back(arg.substr(9));
+        }
+        else if(arg.compare(0, 10, "--threads=") == 0){
+            settings.n_threads = atoi(arg.substr(10).c_str());
+        }
+        else if(arg.compare(0, 14, "--split-depth=") == 0){
+            settings.split_depth = atoi(arg.substr(14).c_str());
         }
+        else if(arg.compare(0, 11, "--families=") == 0){
+            // comma separated numbers of the redundant conditions to be added
+            settings.options.families = 0;
+            std::istringstream iss(arg.substr(11));
+            std::string condition;
+            while(getline(iss, condition, ',')){
+                char* end;
+                long number = strtol(condition.c_str(), &end, 10);
+                if(condition.empty() || *end != '\0' || number < 8 || number > 16){
+                    std::cerr << "Unknown condition " << condition << ", the families are conditions 8 to 16\n";
+                    exit(1);
+                }
+                settings.options.families |= 1u << number;
+            }
+        }
+        else if(arg.compare(0, 6, "--amo=") == 0){
+            if(!parse_amo_encoding(arg.substr(6), settings.options.amo)){
+                std::cerr << "Unknown at-most-one encoding " << arg.substr(6) << "\n";
+                exit(1);
+            }
+        }
+        else{
+            args.push_back(arg);
+        }
+    }
 
-        ofile.open(get_path(out_file));
-        if(!ofile){
-            std::cerr << "Unable to open output file " << argv[2] << "\n";
-            exit(1);
+    std::unique_ptr<ResultCache> cache;
+    try{
+        if(!cache_file.empty()){
+            cache.reset(new ResultCache(cache_file));
+            settings.cache = cache.get();
         }
 
-        solves_rikudo(ifile, ofile);
+        if(daemon){
+            std::ios::sync_with_stdio(false);
+            serve(std::cin, std::cout, settings);
+        }
+        else if(convert){
+            // text board to binary board
+            if(args.size() != 2){
+                std::cerr << "Usage: RikudoSolver --convert graph.txt board.bin\n";
+                exit(1);
+            }
+            std::ifstream ifile(args[0]);
+            if(!ifile)  throw "Unable to open input file";
+            Graph graph(ifile);
+            int source, target;
+            ifile >> source >> target;
+            write_board(args[1], graph.get_adj_list(), source, target);
+        }
+        else if(batch){
+            if(args.size() != 1){
+                std::cerr << "Usage: RikudoSolver --batch [--jobs=N] list.txt\n";
+                exit(1);
+            }
+            std::ifstream list(args[0]);
+            if(!list){
+                std::cerr << "Unable to open list file " << args[0] << "\n";
+                exit(1);
+            }
+            generate_batch(list, n_jobs, settings, std::cout);
+        }
+        else if(pairs){
+            // source and target pairs joined by a hamiltonian path
+            if(args.size() != 1){
+                std::cerr << "Usage: RikudoSolver --pairs [--threads=N] graph.txt\n";
+                exit(1);
+            }
+            Board board = load_board(args[0], settings);
+            Graph& graph = *board.graph;
+            Stats stats;
+            if(settings.stats)  graph.set_stats(&stats);
+            {
+                PhaseTimer timer(settings.stats ? &stats : nullptr, "total");
+                write_pairs(graph, std::cout);
+            }
+            if(settings.stats)  write_stats(stats, "pairs", args[0], graph, settings);
+        }
+        else if(list){
+            // every hamiltonian path, written as soon as it is found
+            if(args.size() != 1){
+                std::cerr << "Usage: RikudoSolver --list graph.txt\n";
+                exit(1);
+            }
+            Board board = load_board(args[0], settings);
+            Graph& graph = *board.graph;
+            Stats stats;
+            if(settings.stats)  graph.set_stats(&stats);
+            {
+                PhaseTimer timer(settings.stats ? &stats : nullptr, "total");
+                graph.for_each_path(board.source, board.target, [](const std::vector<int>& p){
+                    for(int i : p)
+                        std::cout << i << " ";
+                    std::cout << "\n";
+                    return true;
+                }, true, board.map, board.diamonds);
+            }
+            report_kernel(graph, settings);
+            if(settings.stats)  write_stats(stats, "list", args[0], graph, settings);
+        }
+        else if(ablation){
+            if(args.size() != 1){
+                std::cerr << "Usage: RikudoSolver --ablation graph.txt\n";
+                exit(1);
+            }
+            Board board = load_board(args[0], settings);
+            board.graph->ablation(board.source, board.target, 3, std::cout);
+        }
+        else if(count){
+            // number of hamiltonian paths, from the cache, the frontier counter on the
+            // kernel or, when it cannot count the board, the backtracking search
+            if(args.size() != 1){
+                std::cerr << "Usage: RikudoSolver --count [--threads=N] [--split-depth=D] graph.txt\n";
+                exit(1);
+            }
+            Board board = load_board(args[0], settings);
+            Graph& graph = *board.graph;
+            Stats stats;
+            if(settings.stats)  graph.set_stats(&stats);
+            {
+                PhaseTimer timer(settings.stats ? &stats : nullptr, "total");
+                std::cout << graph.count_paths(board.source, board.target, board.map, board.diamonds) << "\n";
+            }
+            report_kernel(graph, settings);
+            if(settings.stats)  write_stats(stats, "count", args[0], graph, settings);
+        }
+        else if(args.size() == 0){
+            std::ofstream ofile("solution.txt");
 
-        ifile.close();
-        ofile.close();
+            solves_rikudo("graph.txt", ofile, settings);
+
+            ofile.close();
+        }
+        else if(args.size() == 1){
+            Board board = load_board(args[0], settings);
+            Graph& graph = *board.graph;
+            Stats stats;
+            if(settings.stats)  graph.set_stats(&stats);
+            {
+                PhaseTimer timer(settings.stats ? &stats : nullptr, "total");
+                write_path(graph, board.source, board.target, settings, std::cout, board.map, board.diamonds);
+            }
+            report_kernel(graph, settings);
+            if(settings.stats)  write_stats(stats, "path", args[0], graph, settings);
+        }
+        else if(args.size() == 2){
+            std::ofstream ofile;
+
+            std::string input = get_path(args[0]);
+            if(!std::ifstream(input)){
+                std::cerr << "Unable to open input file " << args[0] << "\n";
+                exit(1);
+            }
+
+            ofile.open(get_path(args[1]));
+            if(!ofile){
+                std::cerr << "Unable to open output file " << args[1] << "\n";
+                exit(1);
+            }
+
+            solves_rikudo(input, ofile, settings);
+
+            ofile.close();
+        }
+    }
+    catch(const char* message){
+        std::cerr << message << "\n";
+        exit(1);
     }
 
     return 0;
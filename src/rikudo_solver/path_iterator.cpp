@@ -0,0 +1,95 @@
+//
+// Created by:
+//    Cauim de S. Lima - cauimsouza@gmail.com
+//    Victor Hugo Vianna Silva - victor.vianna10@gmail.com
+//
+
+#include "path_iterator.h"
+
+
+PathIterator::PathIterator(const PathProducer& search, long long limit)
+    : limit(limit), n_paths(0), ready(false), wanted(false), done(false), stopped(limit == 0)
+{
+    if(stopped){
+        done = true;
+        return;
+    }
+
+    producer = std::thread([this, search](){
+        // the search only starts when the first path is asked for
+        bool started;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [this]{ return wanted || stopped; });
+            started = !stopped;
+        }
+
+        PathVisitor visitor = [this](const std::vector<int>& p){
+            std::unique_lock<std::mutex> lock(mutex);
+            if(stopped) return false;
+            current = p;
+            ready = true;
+            wanted = false;
+            changed.notify_all();
+            changed.wait(lock, [this]{ return wanted || stopped; });
+            return !stopped;
+        };
+
+        // an exception leaving the thread would end the process
+        std::exception_ptr thrown;
+        try{
+            if(started) search(visitor);
+        }
+        catch(...){
+            thrown = std::current_exception();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        error = thrown;
+        done = true;
+        changed.notify_all();
+    });
+}
+
+PathIterator::~PathIterator()
+{
+    stop();
+    if(producer.joinable()) producer.join();
+}
+
+bool PathIterator::next(std::vector<int>& path)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    if(stopped || done) return false;
+
+    wanted = true;
+    changed.notify_all();
+    changed.wait(lock, [this]{ return ready || done; });
+
+    if(!ready){
+        // errors of the search are raised to the caller
+        if(error){
+            std::exception_ptr thrown = error;
+            error = nullptr;
+            std::rethrow_exception(thrown);
+        }
+        return false;
+    }
+
+    ready = false;
+    path = current;
+    n_paths++;
+    if(n_paths == limit){
+        // the search is not resumed for a path that would not be handed out
+        stopped = true;
+        changed.notify_all();
+    }
+    return true;
+}
+
+void PathIterator::stop()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    stopped = true;
+    changed.notify_all();
+}
@@ -0,0 +1,89 @@
+//
+// Created by:
+//    Cauim de S. Lima - cauimsouza@gmail.com
+//    Victor Hugo Vianna Silva - victor.vianna10@gmail.com
+//
+
+#ifndef RIKUDOSOLVER_PATH_ITERATOR_H
+#define RIKUDOSOLVER_PATH_ITERATOR_H
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "path_search.h"
+
+/**
+ * Search handing every path it finds to a visitor, see Graph::for_each_path
+ */
+typedef std::function<void(const PathVisitor&)> PathProducer;
+
+/**
+ * @brief Hands out the paths of a search one at a time, as the caller asks for them
+ * @details The search runs on a thread of its own in lockstep with the caller: it
+ * waits inside the visitor after every path until the next one is asked for, so no
+ * path is searched before it is needed. Once the limit is reached, or when the
+ * iterator is destroyed, the visitor returns false and the search stops.
+ * The objects used by the search must not be touched by the caller while the iterator
+ * is alive.
+ */
+class PathIterator
+{
+private:
+    long long limit;
+    long long n_paths;
+
+    std::thread producer;
+    std::mutex mutex;
+    std::condition_variable changed;
+
+    /**
+     * a path waiting to be taken, the search being asked for one more, finished,
+     * or told to stop
+     */
+    bool ready;
+    bool wanted;
+    bool done;
+    bool stopped;
+    std::vector<int> current;
+
+    /**
+     * exception thrown by the search, if any
+     */
+    std::exception_ptr error;
+
+public:
+    /**
+     * @param search search giving the paths
+     * @param limit maximum number of paths handed out, or -1 for all of them
+     */
+    PathIterator(const PathProducer& search, long long limit = -1);
+
+    ~PathIterator();
+
+    PathIterator(const PathIterator&) = delete;
+    PathIterator& operator=(const PathIterator&) = delete;
+
+    /**
+     * @brief Resumes the search until it finds the next path
+     *
+     * @param path set to the path found
+     * @return false if the search is over or the limit reached, path being then left
+     * as it was; the errors thrown by the search are thrown again here
+     */
+    bool next(std::vector<int>& path);
+
+    /**
+     * @brief Stops the search, the next calls to next return false
+     */
+    void stop();
+
+    /**
+     * @return number of paths handed out so far
+     */
+    long long get_n_paths() const { return n_paths; }
+};
+
+#endif //RIKUDOSOLVER_PATH_ITERATOR_H
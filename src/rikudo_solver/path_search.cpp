@@ -0,0 +1,525 @@
+//
+// Created by:
+//    Cauim de S. Lima - cauimsouza@gmail.com
+//    Victor Hugo Vianna Silva - victor.vianna10@gmail.com
+//
+
+#include "path_search.h"
+#include "vertex_set.h"
+#include <algorithm>
+#include <climits>
+
+
+template<class VertexSet>
+class BitPathSearch : public PathSearch
+{
+private:
+    int n_vertices;
+
+    /**
+     * adj[v] is the set of neighbors of v, without v itself
+     */
+    std::vector<VertexSet> adj;
+
+    /**
+     * true if every edge goes both ways, the free neighbors rule only holds in this case
+     */
+    bool symmetric;
+
+    /**
+     * dist[u * n_vertices + v] is the length of the shortest path from u to v in the graph
+     */
+    std::vector<int> dist;
+
+    int last;
+
+    /**
+     * fixed_at[i] is the vertex that must be visited at instant i, or -1
+     * pos_of[v] is the instant at which v must be visited, or -1
+     * next_fixed[i] is the first instant j >= i with fixed_at[j] != -1, or n_vertices
+     */
+    std::vector<int> fixed_at;
+    std::vector<int> pos_of;
+    std::vector<int> next_fixed;
+
+    /**
+     * partners[v] lists the vertices that must be visited right before or after v
+     */
+    std::vector< std::vector<int> > partners;
+
+    VertexSet unvisited;
+
+    /**
+     * scratch sets of the flood fill in connected
+     */
+    VertexSet reach;
+    VertexSet frontier;
+    VertexSet next;
+
+    std::vector<int> path;
+    std::vector< std::vector<int> > candidates;
+    std::vector<int> order_key;
+
+    PathVisitor visitor;
+    long long n_found;
+    bool stop;
+
+    /**
+     * whether the search prunes by symmetry, and number of paths each complete path
+     * of the current branch stands for
+     * active[i] holds the indices of the automorphisms fixing path[0] to path[i]
+     * weights[i] is, for every candidate of instant i+1, the number of candidates it
+     * stands for, 0 when another candidate stands for it
+     */
+    bool prune;
+    long long multiplier;
+    std::vector< std::vector<int> > active;
+    std::vector< std::vector<long long> > weights;
+    std::vector<int> orbit_mark;
+    std::vector<int> orbit;
+    int n_orbits;
+
+    /**
+     * depth at which extend records partial paths in prefixes instead of going
+     * deeper, or -1
+     */
+    int split_depth;
+    std::vector< std::vector<int> > prefixes;
+    std::vector<long long> prefix_weights;
+
+    void compute_distances();
+    bool setup(int source, int last,
+               const std::vector< std::pair<int,int> >& map,
+               const std::vector< std::pair<int,int> >& diamonds);
+    bool can_follow(int v, int w, int n);
+    bool connected(int head);
+    bool enough_neighbors(int v, int head);
+    void stabilise(int n);
+    void orbit_weights(int n);
+    void extend(int v, int n);
+    long long start(int source, int last,
+                    const std::vector< std::pair<int,int> >& map,
+                    const std::vector< std::pair<int,int> >& diamonds,
+                    const PathVisitor& visitor,
+                    bool prune);
+    long long resume(const std::vector<int>& prefix, long long weight,
+                     std::vector< std::vector<int> >* found);
+
+public:
+    explicit BitPathSearch(const std::vector< std::vector<int> >& adj_list);
+
+    long long search(int source, int last,
+                     const std::vector< std::pair<int,int> >& map,
+                     const std::vector< std::pair<int,int> >& diamonds,
+                     const PathVisitor& visitor);
+
+    long long search(int source, int last,
+                     const std::vector< std::pair<int,int> >& map,
+                     const std::vector< std::pair<int,int> >& diamonds,
+                     const PathVisitor& visitor,
+                     ThreadPool& pool,
+                     int split_depth);
+};
+
+
+template<class VertexSet>
+BitPathSearch<VertexSet>::BitPathSearch(const std::vector< std::vector<int> >& adj_list)
+    : n_vertices(adj_list.size()), adj(adj_list.size(), VertexSet(adj_list.size())),
+      last(-1), unvisited(n_vertices), reach(n_vertices), frontier(n_vertices),
+      next(n_vertices), n_found(0), stop(false), prune(false), multiplier(1), n_orbits(0),
+      split_depth(-1)
+{
+    for(int u = 0; u < n_vertices; u++)
+        for(int v : adj_list[u])
+            if(v != u)  adj[u].insert(v);
+
+    symmetric = true;
+    for(int u = 0; u < n_vertices; u++)
+        adj[u].for_each([this, u](int v){
+            if(!adj[v].contains(u)) symmetric = false;
+        });
+
+    compute_distances();
+}
+
+template<class VertexSet>
+void BitPathSearch<VertexSet>::compute_distances()
+{
+    dist.assign(n_vertices * n_vertices, INT_MAX);
+    std::vector<int> bfs;
+    for(int s = 0; s < n_vertices; s++){
+        int* d = &dist[s * n_vertices];
+        bfs.clear();
+        bfs.push_back(s);
+        d[s] = 0;
+        for(int i = 0; i < (int) bfs.size(); i++){
+            int u = bfs[i];
+            adj[u].for_each([d, u, &bfs](int w){
+                if(d[w] != INT_MAX) return;
+                d[w] = d[u] + 1;
+                bfs.push_back(w);
+            });
+        }
+    }
+}
+
+// returns false if the constraints contradict each other
+template<class VertexSet>
+bool BitPathSearch<VertexSet>::setup(int source, int last,
+                                     const std::vector< std::pair<int,int> >& map,
+                                     const std::vector< std::pair<int,int> >& diamonds)
+{
+    this->last = last;
+    fixed_at.assign(n_vertices, -1);
+    pos_of.assign(n_vertices, -1);
+    partners.assign(n_vertices, std::vector<int>());
+    path.assign(n_vertices, -1);
+    candidates.assign(n_vertices, std::vector<int>());
+    order_key.assign(n_vertices, 0);
+    unvisited.clear();
+    for(int v = 0; v < n_vertices; v++)
+        unvisited.insert(v);
+
+    std::vector< std::pair<int,int> > fixed(map);
+    fixed.push_back(std::make_pair(0, source));
+    fixed.push_back(std::make_pair(n_vertices - 1, last));
+    for(auto ith_vertex : fixed){
+        int ith = ith_vertex.first;
+        int v = ith_vertex.second;
+        if(ith < 0 || ith >= n_vertices || v < 0 || v >= n_vertices)
+            return false;
+        if(fixed_at[ith] != -1 && fixed_at[ith] != v)   return false;
+        if(pos_of[v] != -1 && pos_of[v] != ith)         return false;
+        fixed_at[ith] = v;
+        pos_of[v] = ith;
+    }
+
+    next_fixed.assign(n_vertices + 1, n_vertices);
+    for(int i = n_vertices - 1; i >= 0; i--)
+        next_fixed[i] = fixed_at[i] != -1 ? i : next_fixed[i+1];
+
+    for(auto u_v : diamonds){
+        int u = u_v.first;
+        int v = u_v.second;
+        if(u == v)  return false;
+        if(std::find(partners[u].begin(), partners[u].end(), v) != partners[u].end())
+            continue;
+        partners[u].push_back(v);
+        partners[v].push_back(u);
+        // a vertex has only two neighbors in the path
+        if(partners[u].size() > 2 || partners[v].size() > 2)
+            return false;
+    }
+
+    // automorphisms fixing the endpoints and the map, and mapping diamonds to diamonds
+    active.assign(n_vertices, std::vector<int>());
+    weights.assign(n_vertices, std::vector<long long>());
+    orbit_mark.assign(n_vertices, 0);
+    n_orbits = 0;
+    for(int k = 0; k < (int) automorphisms.size(); k++){
+        const std::vector<int>& p = automorphisms[k];
+        bool ok = (int) p.size() == n_vertices;
+        for(int v = 0; v < n_vertices && ok; v++){
+            if(pos_of[v] != -1 && p[v] != v)    ok = false;
+            for(int u : partners[v])
+                if(std::find(partners[p[v]].begin(), partners[p[v]].end(), p[u]) == partners[p[v]].end())
+                    ok = false;
+        }
+        if(ok)  active[0].push_back(k);
+    }
+
+    return true;
+}
+
+// keeps the automorphisms of instant n-1 that also fix path[n]
+template<class VertexSet>
+void BitPathSearch<VertexSet>::stabilise(int n)
+{
+    active[n].clear();
+    for(int k : active[n-1])
+        if(automorphisms[k][path[n]] == path[n])
+            active[n].push_back(k);
+}
+
+// splits the candidates of instant n+1 into orbits of the automorphisms fixing the path,
+// the first candidate of an orbit takes its size as weight and the others 0
+template<class VertexSet>
+void BitPathSearch<VertexSet>::orbit_weights(int n)
+{
+    std::vector<int>& cand = candidates[n];
+    std::vector<long long>& weight = weights[n];
+    for(int i = 0; i < (int) cand.size(); i++){
+        if(weight[i] == 0)  continue;
+        n_orbits++;
+        orbit.assign(1, cand[i]);
+        orbit_mark[cand[i]] = n_orbits;
+        for(int j = 0; j < (int) orbit.size(); j++)
+            for(int k : active[n]){
+                int w = automorphisms[k][orbit[j]];
+                if(orbit_mark[w] == n_orbits)   continue;
+                orbit_mark[w] = n_orbits;
+                orbit.push_back(w);
+            }
+
+        // the automorphisms map candidates to candidates, so the whole orbit is in cand
+        for(int j = i + 1; j < (int) cand.size(); j++)
+            if(orbit_mark[cand[j]] == n_orbits){
+                weight[j] = 0;
+                weight[i]++;
+            }
+    }
+}
+
+// checks if vertex w can be visited at instant n+1, right after vertex v
+template<class VertexSet>
+bool BitPathSearch<VertexSet>::can_follow(int v, int w, int n)
+{
+    if(pos_of[w] != -1 && pos_of[w] != n + 1)   return false;
+
+    // w needs a successor for each of its diamonds other than v
+    int pending = 0;
+    for(int p : partners[w]){
+        if(p == v)  continue;
+        if(!unvisited.contains(p))  return false;
+        pending++;
+    }
+    if(pending > (w == last ? 0 : 1))  return false;
+
+    // the next fixed vertex must still be reachable in time
+    int j = next_fixed[n + 2];
+    if(j < n_vertices && dist[w * n_vertices + fixed_at[j]] > j - (n + 1))
+        return false;
+
+    return true;
+}
+
+// checks if every unvisited vertex can be reached from the head of the path
+template<class VertexSet>
+bool BitPathSearch<VertexSet>::connected(int head)
+{
+    reach.clear();
+    frontier.clear();
+    frontier.insert(head);
+    while(!frontier.empty()){
+        next.clear();
+        frontier.for_each([this](int u){
+            next.unite_within(adj[u], unvisited);
+        });
+        frontier.assign_difference(next, reach);
+        reach.unite_within(frontier, unvisited);
+    }
+
+    return unvisited.subset_of(reach);
+}
+
+// checks if the unvisited neighbors of v, which just stopped being the head of
+// the path, still have enough free neighbors to be entered and left
+template<class VertexSet>
+bool BitPathSearch<VertexSet>::enough_neighbors(int v, int head)
+{
+    bool ok = true;
+    next.assign_intersection(adj[v], unvisited);
+    next.for_each([this, head, &ok](int u){
+        int free = adj[u].count_common(unvisited) + adj[u].contains(head);
+        if(free < (u == last ? 1 : 2))  ok = false;
+    });
+    return ok;
+}
+
+// v is the head of the path and was visited at instant n
+template<class VertexSet>
+void BitPathSearch<VertexSet>::extend(int v, int n)
+{
+    if(terminated()){
+        stop = true;
+        return;
+    }
+
+    if(n == split_depth){
+        prefixes.push_back(std::vector<int>(path.begin(), path.begin() + n + 1));
+        prefix_weights.push_back(multiplier);
+        return;
+    }
+
+    if(n == n_vertices - 1){
+        n_found += multiplier;
+        if(visitor && !visitor(path))   stop = true;
+        return;
+    }
+
+    // the successor of v is forced by a diamond not satisfied by its predecessor
+    int pred = n > 0 ? path[n-1] : -1;
+    int required = fixed_at[n + 1];
+    for(int p : partners[v]){
+        if(p == pred)   continue;
+        if(required != -1 && required != p) return;
+        required = p;
+    }
+
+    std::vector<int>& cand = candidates[n];
+    cand.clear();
+    if(required != -1){
+        if(adj[v].contains(required) && unvisited.contains(required) && can_follow(v, required, n))
+            cand.push_back(required);
+    }
+    else{
+        next.assign_intersection(adj[v], unvisited);
+        next.for_each([this, v, n, &cand](int w){
+            if(can_follow(v, w, n)) cand.push_back(w);
+        });
+    }
+
+    // Warnsdorff's rule: vertices with less free neighbors first
+    for(int w : cand)
+        order_key[w] = adj[w].count_common(unvisited);
+    std::sort(cand.begin(), cand.end(), [this](int a, int b){
+        return order_key[a] < order_key[b];
+    });
+
+    std::vector<long long>& weight = weights[n];
+    weight.assign(cand.size(), 1);
+    if(prune && !active[n].empty())
+        orbit_weights(n);
+
+    bool last_step = n + 2 == n_vertices;
+    for(int i = 0; i < (int) cand.size() && !stop; i++){
+        if(weight[i] == 0)  continue;
+        int w = cand[i];
+        unvisited.erase(w);
+        path[n + 1] = w;
+
+        bool ok = last_step ||
+            ((!symmetric || enough_neighbors(v, w)) && connected(w));
+        if(ok){
+            if(prune)   stabilise(n + 1);
+            multiplier *= weight[i];
+            extend(w, n + 1);
+            multiplier /= weight[i];
+        }
+
+        unvisited.insert(w);
+    }
+}
+
+template<class VertexSet>
+long long BitPathSearch<VertexSet>::search(int source, int last,
+                                           const std::vector< std::pair<int,int> >& map,
+                                           const std::vector< std::pair<int,int> >& diamonds,
+                                           const PathVisitor& visitor)
+{
+    // every path must be visited, unless the paths are only counted
+    return start(source, last, map, diamonds, visitor, !visitor);
+}
+
+template<class VertexSet>
+long long BitPathSearch<VertexSet>::start(int source, int last,
+                                          const std::vector< std::pair<int,int> >& map,
+                                          const std::vector< std::pair<int,int> >& diamonds,
+                                          const PathVisitor& visitor,
+                                          bool prune)
+{
+    n_found = 0;
+    stop = false;
+    multiplier = 1;
+    this->prune = prune && !automorphisms.empty();
+    this->visitor = visitor;
+
+    if(n_vertices == 0 || !setup(source, last, map, diamonds))
+        return 0;
+    if(n_vertices > 1 && (source == last || dist[source * n_vertices + last] == INT_MAX))
+        return 0;
+
+    // the source has no predecessor, so all its diamonds go to its successor
+    if((int) partners[source].size() > (n_vertices > 1 ? 1 : 0))
+        return 0;
+
+    unvisited.erase(source);
+    path[0] = source;
+    extend(source, 0);
+
+    return n_found;
+}
+
+
+// continues the search from a partial path built by the same engine, the complete
+// paths are stored in found unless it is null
+template<class VertexSet>
+long long BitPathSearch<VertexSet>::resume(const std::vector<int>& prefix, long long weight,
+                                           std::vector< std::vector<int> >* found)
+{
+    n_found = 0;
+    stop = false;
+    multiplier = weight;
+    if(found)   visitor = [found](const std::vector<int>& p){ found->push_back(p); return true; };
+    else        visitor = PathVisitor();
+
+    unvisited.clear();
+    for(int v = 0; v < n_vertices; v++)
+        unvisited.insert(v);
+    for(int i = 0; i < (int) prefix.size(); i++){
+        path[i] = prefix[i];
+        unvisited.erase(prefix[i]);
+        if(prune && i > 0)  stabilise(i);
+    }
+
+    extend(prefix.back(), prefix.size() - 1);
+    return n_found;
+}
+
+template<class VertexSet>
+long long BitPathSearch<VertexSet>::search(int source, int last,
+                                           const std::vector< std::pair<int,int> >& map,
+                                           const std::vector< std::pair<int,int> >& diamonds,
+                                           const PathVisitor& visitor,
+                                           ThreadPool& pool,
+                                           int split_depth)
+{
+    // the sequential search up to split_depth leaves the partial paths in prefixes
+    prefixes.clear();
+    prefix_weights.clear();
+    this->split_depth = std::max(0, std::min(split_depth, n_vertices - 1));
+    start(source, last, map, diamonds, PathVisitor(), !visitor);
+    this->split_depth = -1;
+
+    std::vector< std::vector<int> > tasks;
+    std::vector<long long> task_weights;
+    tasks.swap(prefixes);
+    task_weights.swap(prefix_weights);
+
+    // the copies share the constraints set up by the search above
+    std::vector<BitPathSearch> engines(pool.size(), *this);
+    std::vector<long long> counts(tasks.size(), 0);
+    std::vector< std::vector< std::vector<int> > > found(visitor ? tasks.size() : 0);
+    for(int t = 0; t < (int) tasks.size(); t++){
+        pool.submit([&, t](int worker){
+            counts[t] = engines[worker].resume(tasks[t], task_weights[t], visitor ? &found[t] : nullptr);
+        });
+    }
+    pool.wait();
+
+    long long total = 0;
+    for(long long count : counts)
+        total += count;
+    if(!visitor)    return total;
+
+    long long n_visited = 0;
+    for(auto& task_paths : found)
+        for(auto& p : task_paths){
+            n_visited++;
+            if(!visitor(p)) return n_visited;
+        }
+    return total;
+}
+
+
+std::unique_ptr<PathSearch> PathSearch::create(const std::vector< std::vector<int> >& adj_list)
+{
+    int n = adj_list.size();
+    if(n <= 64)
+        return std::unique_ptr<PathSearch>(new BitPathSearch< FixedVertexSet<64> >(adj_list));
+    if(n <= 128)
+        return std::unique_ptr<PathSearch>(new BitPathSearch< FixedVertexSet<128> >(adj_list));
+    if(n <= 256)
+        return std::unique_ptr<PathSearch>(new BitPathSearch< FixedVertexSet<256> >(adj_list));
+    return std::unique_ptr<PathSearch>(new BitPathSearch<DynamicVertexSet>(adj_list));
+}
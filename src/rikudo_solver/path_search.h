@@ -0,0 +1,126 @@
+//
+// Created by:
+//    Cauim de S. Lima - cauimsouza@gmail.com
+//    Victor Hugo Vianna Silva - victor.vianna10@gmail.com
+//
+
+#ifndef RIKUDOSOLVER_PATH_SEARCH_H
+#define RIKUDOSOLVER_PATH_SEARCH_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "thread_pool.h"
+
+/**
+ * Function called for every hamiltonian path found by a search
+ * it returns false to stop the search, an empty function only counts the paths
+ */
+typedef std::function<bool(const std::vector<int>&)> PathVisitor;
+
+/**
+ * @brief Depth first search of hamiltonian paths under map and diamond constraints
+ * @details The constraints are checked while the path is extended instead of on
+ * complete paths. A partial path is also abandoned when
+ * - an unvisited vertex is left with less free neighbors than it needs (two, or one
+ * for the last vertex of the path), which is only checked on undirected graphs,
+ * - the unvisited vertices are no longer connected to the head of the path,
+ * - the next vertex fixed by the map is farther than the number of steps left to reach it.
+ * Neighbors are tried in increasing order of free neighbors (Warnsdorff's rule).
+ *
+ * A search that only counts, with no visitor, prunes by symmetry: among the next vertices
+ * that an automorphism of the graph fixing the partial path, the destination and the map
+ * and preserving the diamonds maps to each other, only the first is searched, and its
+ * paths are counted once for each of them.
+ *
+ * The implementations keep the adjacency and the visited vertices as bitsets, see
+ * vertex_set.h, whose width is fixed at compile time for boards of up to 256 vertices.
+ */
+class PathSearch
+{
+protected:
+    const std::atomic<bool>* terminate_flag;
+
+    /**
+     * automorphisms of the graph used to prune the counting searches, see Symmetry
+     */
+    std::vector< std::vector<int> > automorphisms;
+
+    /**
+     * @return true if the caller asked the current search to stop
+     */
+    bool terminated() const
+    {
+        return terminate_flag && terminate_flag->load(std::memory_order_relaxed);
+    }
+
+public:
+    PathSearch() : terminate_flag(nullptr) {}
+    virtual ~PathSearch() {}
+
+    /**
+     * @brief Makes the searches stop as soon as the flag is set, the flag may be set
+     * from another thread
+     *
+     * @param flag flag polled during the search, or nullptr
+     */
+    void set_terminate(const std::atomic<bool>* flag) { terminate_flag = flag; }
+
+    /**
+     * @brief Gives the automorphisms of the graph to the counting searches
+     *
+     * @param automorphisms permutations of the vertices mapping every edge to an edge,
+     * not necessarily the whole group
+     */
+    void set_automorphisms(const std::vector< std::vector<int> >& automorphisms)
+    {
+        this->automorphisms = automorphisms;
+    }
+
+    /**
+     * @brief Builds the search engine best suited to the size of the graph
+     *
+     * @param adj_list adjacence list of the graph
+     * @return engine using 64, 128 or 256 bit vertex sets, or dynamic ones for
+     * larger graphs
+     */
+    static std::unique_ptr<PathSearch> create(const std::vector< std::vector<int> >& adj_list);
+
+    /**
+     * @brief Visits the hamiltonian paths from source to last respecting the constraints
+     *
+     * @param source origin of the paths
+     * @param last destination of the paths
+     * @param map list of pairs of integers of the form (i, v) representing
+     * the condition "vertex v must be visited at instant i"
+     * @param diamonds list of diamonds in the form of a list of pairs of integers of the form (u, v) representing
+     * the condition "vertex v and vertex u must be visited consecutively, in any order"
+     * @param visitor function called for every path found, the search stops when it returns false
+     * @return number of paths found
+     */
+    virtual long long search(int source, int last,
+                             const std::vector< std::pair<int,int> >& map,
+                             const std::vector< std::pair<int,int> >& diamonds,
+                             const PathVisitor& visitor) = 0;
+
+    /**
+     * @brief Same as the sequential search, but run by the workers of a thread pool
+     * @details The search tree is cut at depth split_depth and every partial path of
+     * that length becomes a task. Each worker searches with its own copy of the engine
+     * and the paths found by a task are kept until all tasks finish, then they are given
+     * to the visitor in the order of the sequential search, from the calling thread.
+     *
+     * @param pool workers running the tasks
+     * @param split_depth number of steps taken before the tree is split
+     */
+    virtual long long search(int source, int last,
+                             const std::vector< std::pair<int,int> >& map,
+                             const std::vector< std::pair<int,int> >& diamonds,
+                             const PathVisitor& visitor,
+                             ThreadPool& pool,
+                             int split_depth) = 0;
+};
+
+#endif //RIKUDOSOLVER_PATH_SEARCH_H
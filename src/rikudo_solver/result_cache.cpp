@@ -0,0 +1,245 @@
+//
+// Created by:
+//    Cauim de S. Lima - cauimsouza@gmail.com
+//    Victor Hugo Vianna Silva - victor.vianna10@gmail.com
+//
+
+#include "result_cache.h"
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define cache_magic "RIKUDOC"
+
+
+namespace
+{
+    struct CacheHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t reserved;
+    };
+
+    struct RecordHeader
+    {
+        uint64_t hash;
+        uint32_t key_size;
+        uint32_t value_size;
+    };
+
+    size_t record_size(const RecordHeader& record)
+    {
+        size_t bytes = sizeof(RecordHeader) + (size_t) record.key_size + record.value_size;
+        return (bytes + 7) / 8 * 8;
+    }
+
+    // end of the last complete record of a file of a given size
+    size_t valid_end(int fd, size_t file_size)
+    {
+        size_t offset = sizeof(CacheHeader);
+        RecordHeader record;
+        while(offset + sizeof(RecordHeader) <= file_size){
+            if(pread(fd, &record, sizeof(record), offset) != (ssize_t) sizeof(record))
+                break;
+            if(offset + record_size(record) > file_size)
+                break;
+            offset += record_size(record);
+        }
+        return offset;
+    }
+
+    // writes a whole buffer, returns false on error
+    bool write_all(int fd, const char* buffer, size_t n)
+    {
+        while(n > 0){
+            ssize_t written = write(fd, buffer, n);
+            if(written <= 0)    return false;
+            buffer += written;
+            n -= written;
+        }
+        return true;
+    }
+}
+
+
+ResultCache::ResultCache(const std::string& path)
+    : path(path), fd(-1), data(nullptr), size(0), indexed(sizeof(CacheHeader))
+{
+    fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if(fd < 0)
+        throw "Unable to open cache file";
+
+    // the header is written, and a record cut by a crash dropped, by one process at a time
+    const char* error = nullptr;
+    flock(fd, LOCK_EX);
+    struct stat st;
+    if(fstat(fd, &st) < 0){
+        error = "Unable to open cache file";
+    }
+    else if(st.st_size == 0){
+        CacheHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, cache_magic, sizeof(cache_magic));
+        header.version = CACHE_FILE_VERSION;
+        if(!write_all(fd, reinterpret_cast<const char*>(&header), sizeof(header)))
+            error = "Unable to write cache file";
+    }
+    else{
+        CacheHeader header;
+        if(st.st_size < (off_t) sizeof(header) ||
+           pread(fd, &header, sizeof(header), 0) != (ssize_t) sizeof(header) ||
+           std::memcmp(header.magic, cache_magic, sizeof(cache_magic)) != 0)
+            error = "Invalid cache file";
+        else if(header.version != CACHE_FILE_VERSION)
+            error = "Unsupported cache file version";
+        else{
+            size_t end = valid_end(fd, st.st_size);
+            if(end < (size_t) st.st_size && ftruncate(fd, end) < 0)
+                error = "Unable to write cache file";
+        }
+    }
+    flock(fd, LOCK_UN);
+
+    if(error){
+        close(fd);
+        throw error;
+    }
+    remap();
+}
+
+ResultCache::~ResultCache()
+{
+    if(data)    munmap(data, size);
+    if(fd >= 0) close(fd);
+}
+
+void ResultCache::remap()
+{
+    struct stat st;
+    if(fstat(fd, &st) < 0 || (size_t) st.st_size <= size)
+        return;
+
+    if(data)    munmap(data, size);
+    size = st.st_size;
+    data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if(data == MAP_FAILED){
+        // the results stay out of reach, the runs are only slower
+        data = nullptr;
+        size = 0;
+        indexed = sizeof(CacheHeader);
+        index.clear();
+        return;
+    }
+
+    const char* begin = static_cast<const char*>(data);
+    while(indexed + sizeof(RecordHeader) <= size){
+        const RecordHeader* record = reinterpret_cast<const RecordHeader*>(begin + indexed);
+        if(indexed + record_size(*record) > size)
+            break;
+        index.insert(std::make_pair(record->hash, indexed));
+        indexed += record_size(*record);
+    }
+}
+
+bool ResultCache::lookup(const std::string& key, std::string& value)
+{
+    if(!data)   return false;
+    const char* begin = static_cast<const char*>(data);
+    auto range = index.equal_range(hash(key));
+    for(auto it = range.first; it != range.second; ++it){
+        const RecordHeader* record = reinterpret_cast<const RecordHeader*>(begin + it->second);
+        const char* stored_key = begin + it->second + sizeof(RecordHeader);
+        if(record->key_size != key.size() || std::memcmp(stored_key, key.data(), key.size()) != 0)
+            continue;
+        value.assign(stored_key + record->key_size, record->value_size);
+        return true;
+    }
+    return false;
+}
+
+bool ResultCache::find(const std::string& key, std::string& value)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if(lookup(key, value))  return true;
+
+    // other processes may have stored it since the last mapping
+    remap();
+    return lookup(key, value);
+}
+
+void ResultCache::store(const std::string& key, const std::string& value)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    RecordHeader record;
+    record.hash = hash(key);
+    record.key_size = key.size();
+    record.value_size = value.size();
+    std::string bytes(reinterpret_cast<const char*>(&record), sizeof(record));
+    bytes += key;
+    bytes += value;
+    bytes.resize(record_size(record), '\0');
+
+    // a failed append only loses this result, the cache stays readable
+    flock(fd, LOCK_EX);
+    if(lseek(fd, 0, SEEK_END) >= 0 && !write_all(fd, bytes.data(), bytes.size())){
+        struct stat st;
+        if(fstat(fd, &st) == 0) ftruncate(fd, valid_end(fd, st.st_size));
+    }
+    flock(fd, LOCK_UN);
+    remap();
+}
+
+std::string ResultCache::key(const std::string& mode,
+                             const std::vector< std::vector<int> >& adj_list,
+                             int source, int target,
+                             const std::vector< std::pair<int,int> >& map,
+                             const std::vector< std::pair<int,int> >& diamonds)
+{
+    std::ostringstream out;
+    out << mode << "\n" << adj_list.size() << "\n";
+    for(auto& list : adj_list){
+        std::vector<int> neighbors(list);
+        std::sort(neighbors.begin(), neighbors.end());
+        neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+        for(int v : neighbors)
+            out << v << " ";
+        out << "\n";
+    }
+    out << source << " " << target << "\n";
+
+    std::vector< std::pair<int,int> > sorted_map(map);
+    std::sort(sorted_map.begin(), sorted_map.end());
+    sorted_map.erase(std::unique(sorted_map.begin(), sorted_map.end()), sorted_map.end());
+    for(auto ith_vertex : sorted_map)
+        out << ith_vertex.first << ":" << ith_vertex.second << " ";
+    out << "\n";
+
+    std::vector< std::pair<int,int> > sorted_diamonds;
+    for(auto u_v : diamonds)
+        sorted_diamonds.push_back(std::make_pair(std::min(u_v.first, u_v.second),
+                                                 std::max(u_v.first, u_v.second)));
+    std::sort(sorted_diamonds.begin(), sorted_diamonds.end());
+    sorted_diamonds.erase(std::unique(sorted_diamonds.begin(), sorted_diamonds.end()), sorted_diamonds.end());
+    for(auto u_v : sorted_diamonds)
+        out << u_v.first << "-" << u_v.second << " ";
+    out << "\n";
+
+    return out.str();
+}
+
+uint64_t ResultCache::hash(const std::string& key)
+{
+    uint64_t h = 14695981039346656037ull;
+    for(unsigned char c : key){
+        h ^= c;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
@@ -0,0 +1,115 @@
+//
+// Created by:
+//    Cauim de S. Lima - cauimsouza@gmail.com
+//    Victor Hugo Vianna Silva - victor.vianna10@gmail.com
+//
+
+#ifndef RIKUDOSOLVER_RESULT_CACHE_H
+#define RIKUDOSOLVER_RESULT_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * Version of the cache file format
+ */
+const uint32_t CACHE_FILE_VERSION = 1;
+
+/**
+ * @brief Results of earlier runs kept in a file, found again by the query that gave them
+ * @details A query is described by a key in canonical form: the mode, the sorted
+ * adjacency lists without repeated edges, the endpoints and the sorted constraints, so
+ * the order in which a board lists its edges does not matter. A key is identified by
+ * its 64 bit FNV-1a hash, the whole key being compared on a hit.
+ *
+ * The file is a header followed by records (hash, key size, value size, key, value)
+ * padded to 8 bytes. It is mapped in memory and indexed when opened, a lookup is then
+ * a hash table probe and a comparison inside the mapping. Records are only appended,
+ * under an exclusive flock, so several processes can share the file: the records the
+ * others append are indexed on the next miss. A record cut by a crash is dropped when
+ * the file is opened.
+ *
+ * The methods may be called from several threads.
+ */
+class ResultCache
+{
+private:
+    std::string path;
+    int fd;
+    void* data;
+    size_t size;
+
+    /**
+     * offset of the first record not indexed yet, and offsets of the records by hash
+     */
+    size_t indexed;
+    std::unordered_multimap<uint64_t, size_t> index;
+
+    std::mutex mutex;
+
+    /**
+     * @brief Maps the file again if it grew and indexes its new records
+     */
+    void remap();
+
+    /**
+     * @brief Looks a key up in the records indexed so far
+     */
+    bool lookup(const std::string& key, std::string& value);
+
+public:
+    /**
+     * @param path cache file, created if it does not exist
+     */
+    explicit ResultCache(const std::string& path);
+    ~ResultCache();
+
+    ResultCache(const ResultCache&) = delete;
+    ResultCache& operator=(const ResultCache&) = delete;
+
+    /**
+     * @brief Builds the canonical key of a query
+     *
+     * @param mode what is computed, results of different modes never match
+     * @param adj_list adjacence list of the board
+     * @param source origin of the paths
+     * @param target destination of the paths
+     * @param map list of pairs (i, v) representing "vertex v must be visited at instant i"
+     * @param diamonds list of pairs (u, v) representing "u and v must be visited consecutively"
+     * @return key of the query
+     */
+    static std::string key(const std::string& mode,
+                           const std::vector< std::vector<int> >& adj_list,
+                           int source, int target,
+                           const std::vector< std::pair<int,int> >& map = {},
+                           const std::vector< std::pair<int,int> >& diamonds = {});
+
+    /**
+     * @return FNV-1a hash of a key
+     */
+    static uint64_t hash(const std::string& key);
+
+    /**
+     * @brief Finds the result stored for a key
+     *
+     * @param key key built by ResultCache::key
+     * @param value set to the result when it is found
+     * @return true if the key was found
+     */
+    bool find(const std::string& key, std::string& value);
+
+    /**
+     * @brief Appends a result to the file
+     *
+     * @param key key built by ResultCache::key
+     * @param value result of the query
+     */
+    void store(const std::string& key, const std::string& value);
+};
+
+#endif //RIKUDOSOLVER_RESULT_CACHE_H
@@ -0,0 +1,168 @@
+//
+// Created by:
+//    Cauim de S. Lima - cauimsouza@gmail.com
+//    Victor Hugo Vianna Silva - victor.vianna10@gmail.com
+//
+
+#include "sat_solver.h"
+#include "dimacs_writer.h"
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <csignal>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// microseconds between two checks of the terminate flag while the solver runs
+#define poll_interval 1000
+
+
+void ClauseSink::add_clause(const std::vector<int>& clause)
+{
+    for(int lit : clause)
+        add(lit);
+    add(0);
+}
+
+ExternalSatSolver::ExternalSatSolver(const std::string& solver_path,
+                                     const std::string& input_path,
+                                     const std::string& output_path)
+    : solver_path(solver_path), input_path(input_path), output_path(output_path),
+      n_vars(0), status(SAT_UNKNOWN)
+{
+}
+
+void ExternalSatSolver::add(int lit)
+{
+    literals.push_back(lit);
+    n_vars = std::max(n_vars, std::abs(lit));
+}
+
+void ExternalSatSolver::assume(int lit)
+{
+    assumptions.push_back(lit);
+    n_vars = std::max(n_vars, std::abs(lit));
+}
+
+void ExternalSatSolver::write_dimacs()
+{
+    DimacsWriter writer(input_path);
+
+    for(int lit : literals)
+        writer.add(lit);
+    for(int lit : assumptions){
+        writer.add(lit);
+        writer.add(0);
+    }
+
+    writer.close();
+    if(stats)   stats->add("bytes_written", writer.bytes());
+}
+
+void ExternalSatSolver::read_output()
+{
+    std::ifstream ifs(output_path);
+    std::string line;
+
+    model.assign(n_vars + 1, false);
+    status = SAT_UNKNOWN;
+    long long n_bytes = 0;
+    while(getline(ifs, line)){
+        n_bytes += line.size() + 1;
+        std::istringstream iss(line);
+
+        std::string type;
+        iss >> type;
+
+        if(type == "s"){
+            std::string answer;
+            iss >> answer;
+            if(answer == "SATISFIABLE")         status = SAT_SATISFIABLE;
+            else if(answer == "UNSATISFIABLE")  status = SAT_UNSATISFIABLE;
+        }
+        else if(type == "v"){
+            int val;
+            while(iss >> val){
+                if(val > 0 && val <= n_vars)
+                    model[val] = true;
+            }
+        }
+    }
+
+    ifs.close();
+    if(stats)   stats->add("bytes_read", n_bytes);
+}
+
+// runs "solver input > output", returns false if the process was killed
+bool ExternalSatSolver::run()
+{
+    pid_t pid = fork();
+    if(pid < 0) return false;
+    if(pid == 0){
+        int fd = open(output_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if(fd < 0)  _exit(127);
+        dup2(fd, STDOUT_FILENO);
+        close(fd);
+        execl(solver_path.c_str(), solver_path.c_str(), input_path.c_str(), (char*) nullptr);
+        _exit(127);
+    }
+
+    int wstatus;
+    if(!terminate_flag){
+        waitpid(pid, &wstatus, 0);
+        return true;
+    }
+
+    while(waitpid(pid, &wstatus, WNOHANG) == 0){
+        if(terminated()){
+            kill(pid, SIGKILL);
+            waitpid(pid, &wstatus, 0);
+            return false;
+        }
+        usleep(poll_interval);
+    }
+    return true;
+}
+
+int ExternalSatSolver::solve()
+{
+    {
+        PhaseTimer timer(stats, "write_sat");
+        write_dimacs();
+    }
+
+    bool finished;
+    {
+        PhaseTimer timer(stats, "external_run");
+        finished = run();
+    }
+
+    if(finished){
+        PhaseTimer timer(stats, "read_output");
+        read_output();
+    }
+    else{
+        status = SAT_UNKNOWN;
+    }
+
+    last_assumptions.swap(assumptions);
+    assumptions.clear();
+    return status;
+}
+
+int ExternalSatSolver::val(int lit)
+{
+    int var = std::abs(lit);
+    bool value = var < (int) model.size() && model[var];
+    if(lit < 0) value = !value;
+    return value ? lit : -lit;
+}
+
+bool ExternalSatSolver::failed(int lit)
+{
+    // the binary gives us no final conflict, so every assumption is reported as used
+    return status == SAT_UNSATISFIABLE &&
+        std::find(last_assumptions.begin(), last_assumptions.end(), lit) != last_assumptions.end();
+}
@@ -0,0 +1,206 @@
+//
+// Created by:
+//    Cauim de S. Lima - cauimsouza@gmail.com
+//    Victor Hugo Vianna Silva - victor.vianna10@gmail.com
+//
+
+#ifndef RIKUDOSOLVER_SAT_SOLVER_H
+#define RIKUDOSOLVER_SAT_SOLVER_H
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include "stats.h"
+
+/**
+ * Return codes of SatSolver::solve, following the IPASIR convention
+ */
+const int SAT_UNKNOWN = 0;
+const int SAT_SATISFIABLE = 10;
+const int SAT_UNSATISFIABLE = 20;
+
+/**
+ * Available implementations of SatSolver
+ */
+enum class SatBackend
+{
+    EMBEDDED, // in-process CDCL solver, see cdcl_solver.h
+    EXTERNAL  // cryptominisat binary run through the shell
+};
+
+/**
+ * @brief Destination of a stream of clauses
+ * @details Literals are non-zero integers in DIMACS notation: variable v
+ * is the literal v and its negation is -v. Clauses are written one literal
+ * at a time and terminated by a 0, so no clause has to be materialised.
+ */
+class ClauseSink
+{
+public:
+    virtual ~ClauseSink() {}
+
+    /**
+     * @brief Adds a literal to the clause currently being built
+     *
+     * @param lit literal to be added, or 0 to finish the clause and add it
+     * to the formula
+     */
+    virtual void add(int lit) = 0;
+
+    /**
+     * @brief Adds a whole clause to the formula
+     *
+     * @param clause list of literals of the clause, without the terminating 0
+     */
+    void add_clause(const std::vector<int>& clause);
+};
+
+/**
+ * @brief Forwards clauses to another sink while counting them
+ */
+class CountingSink : public ClauseSink
+{
+private:
+    ClauseSink& sink;
+
+public:
+    long long n_clauses;
+    long long n_literals;
+
+    explicit CountingSink(ClauseSink& sink) : sink(sink), n_clauses(0), n_literals(0) {}
+
+    void add(int lit)
+    {
+        if(lit == 0)    n_clauses++;
+        else            n_literals++;
+        sink.add(lit);
+    }
+};
+
+/**
+ * @brief Incremental SAT solver with an IPASIR-like interface
+ * @details Clauses and assumptions added to the solver survive between calls
+ * to solve, so the solver can be kept alive and reused for a sequence of
+ * related queries.
+ */
+class SatSolver : public ClauseSink
+{
+protected:
+    const std::atomic<bool>* terminate_flag;
+
+    /**
+     * measures of the run, or nullptr when stats are off
+     */
+    Stats* stats;
+
+    /**
+     * @return true if the caller asked the current call to solve to stop
+     */
+    bool terminated() const
+    {
+        return terminate_flag && terminate_flag->load(std::memory_order_relaxed);
+    }
+
+public:
+    SatSolver() : terminate_flag(nullptr), stats(nullptr) {}
+
+    /**
+     * @brief Makes solve give up and return SAT_UNKNOWN as soon as the flag is set,
+     * the flag may be set from another thread
+     *
+     * @param flag flag polled during the search, or nullptr
+     */
+    void set_terminate(const std::atomic<bool>* flag) { terminate_flag = flag; }
+
+    /**
+     * @brief Records the time and the input/output of the next calls to solve
+     *
+     * @param stats where the measures are added, or nullptr
+     */
+    void set_stats(Stats* stats) { this->stats = stats; }
+
+    /**
+     * @brief Assumes a literal to be true for the next call to solve only
+     *
+     * @param lit literal to be assumed
+     */
+    virtual void assume(int lit) = 0;
+
+    /**
+     * @brief Solves the formula under the current assumptions
+     * @details The assumptions are cleared after the call
+     *
+     * @return SAT_SATISFIABLE, SAT_UNSATISFIABLE or SAT_UNKNOWN
+     */
+    virtual int solve() = 0;
+
+    /**
+     * @brief Returns the value of a literal in the model found by the last call to solve
+     *
+     * @param lit literal whose value we want to know
+     * @return lit if it is true in the model, -lit otherwise
+     */
+    virtual int val(int lit) = 0;
+
+    /**
+     * @brief Checks if an assumption was used to prove unsatisfiability in the last call
+     * to solve
+     *
+     * @param lit assumption of the last call to solve
+     * @return true if the assumption is part of the final conflict
+     */
+    virtual bool failed(int lit) = 0;
+};
+
+
+/**
+ * @brief Solver that runs an external DIMACS solver binary at every call to solve
+ * @details The formula is kept in memory and written to a file right before the
+ * solver is executed, with the assumptions added as unit clauses. It does not
+ * keep any learned information between calls. When the terminate flag is set,
+ * the solver process is killed.
+ */
+class ExternalSatSolver : public SatSolver
+{
+private:
+    std::string solver_path;
+    std::string input_path;
+    std::string output_path;
+
+    /**
+     * clauses of the formula, each one terminated by a 0
+     */
+    std::vector<int> literals;
+    int n_vars;
+
+    std::vector<int> assumptions;
+    std::vector<int> last_assumptions;
+
+    /**
+     * model[v] is true if variable v is true in the last model found
+     */
+    std::vector<bool> model;
+    int status;
+
+    void write_dimacs();
+    bool run();
+    void read_output();
+
+public:
+    /**
+     * @param solver_path path of the solver binary
+     * @param input_path file where the formula is written
+     * @param output_path file where the output of the solver is redirected
+     */
+    ExternalSatSolver(const std::string& solver_path,
+                      const std::string& input_path,
+                      const std::string& output_path);
+
+    void add(int lit);
+    void assume(int lit);
+    int solve();
+    int val(int lit);
+    bool failed(int lit);
+};
+
+#endif //RIKUDOSOLVER_SAT_SOLVER_H
@@ -0,0 +1,127 @@
+//
+// Created by:
+//    Cauim de S. Lima - cauimsouza@gmail.com
+//    Victor Hugo Vianna Silva - victor.vianna10@gmail.com
+//
+
+#include "stats.h"
+#include <cstdio>
+#include <sys/resource.h>
+
+
+namespace
+{
+    // writes a JSON string literal
+    void write_string(std::ostream& out, const std::string& s)
+    {
+        out << '"';
+        for(char c : s){
+            if(c == '"' || c == '\\'){
+                out << '\\' << c;
+            }
+            else if((unsigned char) c < 0x20){
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                out << escaped;
+            }
+            else{
+                out << c;
+            }
+        }
+        out << '"';
+    }
+}
+
+
+void Stats::add_phase(const std::string& name, double seconds)
+{
+    auto it = phases.find(name);
+    if(it == phases.end()){
+        Phase phase = {seconds, 1};
+        phases[name] = phase;
+        return;
+    }
+    it->second.seconds += seconds;
+    it->second.calls++;
+}
+
+void Stats::add_family(const std::string& name, long long n_vars, long long n_clauses, long long n_literals)
+{
+    for(auto& family : families)
+        if(family.name == name){
+            family.n_vars += n_vars;
+            family.n_clauses += n_clauses;
+            family.n_literals += n_literals;
+            return;
+        }
+    Family family = {name, n_vars, n_clauses, n_literals};
+    families.push_back(family);
+}
+
+void Stats::add_probe(int prefix, bool unique, bool deduced, double seconds)
+{
+    Probe probe = {prefix, unique, deduced, seconds};
+    probes.push_back(probe);
+}
+
+void Stats::add(const std::string& name, long long value)
+{
+    counters[name] += value;
+}
+
+void Stats::set_label(const std::string& name, const std::string& value)
+{
+    labels[name] = value;
+}
+
+void Stats::write_json(std::ostream& out) const
+{
+    // ru_maxrss is in kilobytes on linux
+    struct rusage usage;
+    long long peak_rss = getrusage(RUSAGE_SELF, &usage) == 0 ? usage.ru_maxrss : -1;
+
+    out << "{";
+    for(auto& label : labels){
+        write_string(out, label.first);
+        out << ":";
+        write_string(out, label.second);
+        out << ",";
+    }
+    for(auto& counter : counters){
+        write_string(out, counter.first);
+        out << ":" << counter.second << ",";
+    }
+    out << "\"peak_rss_kb\":" << peak_rss;
+
+    out << ",\"phases\":{";
+    bool first = true;
+    for(auto& phase : phases){
+        if(!first)  out << ",";
+        first = false;
+        write_string(out, phase.first);
+        out << ":{\"seconds\":" << phase.second.seconds << ",\"calls\":" << phase.second.calls << "}";
+    }
+    out << "}";
+
+    out << ",\"families\":[";
+    for(int i = 0; i < (int) families.size(); i++){
+        const Family& family = families[i];
+        if(i > 0)   out << ",";
+        out << "{\"name\":";
+        write_string(out, family.name);
+        out << ",\"vars\":" << family.n_vars << ",\"clauses\":" << family.n_clauses
+            << ",\"literals\":" << family.n_literals << "}";
+    }
+    out << "]";
+
+    out << ",\"probes\":[";
+    for(int i = 0; i < (int) probes.size(); i++){
+        const Probe& probe = probes[i];
+        if(i > 0)   out << ",";
+        out << "{\"prefix\":" << probe.prefix
+            << ",\"unique\":" << (probe.unique ? "true" : "false")
+            << ",\"deduced\":" << (probe.deduced ? "true" : "false")
+            << ",\"seconds\":" << probe.seconds << "}";
+    }
+    out << "]}\n";
+}
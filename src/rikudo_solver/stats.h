@@ -0,0 +1,124 @@
+//
+// Created by:
+//    Cauim de S. Lima - cauimsouza@gmail.com
+//    Victor Hugo Vianna Silva - victor.vianna10@gmail.com
+//
+
+#ifndef RIKUDOSOLVER_STATS_H
+#define RIKUDOSOLVER_STATS_H
+
+#include <chrono>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Measures of a run: time per phase, size of every condition family, binary
+ * search probes and bytes exchanged with the external solver
+ * @details A Stats is filled by a single thread at a time. The code being measured
+ * holds a pointer to it which is null when stats are off, so the only cost is then
+ * a test of that pointer.
+ */
+class Stats
+{
+private:
+    struct Phase
+    {
+        double seconds;
+        long long calls;
+    };
+
+    struct Family
+    {
+        std::string name;
+        long long n_vars;
+        long long n_clauses;
+        long long n_literals;
+    };
+
+    struct Probe
+    {
+        int prefix;
+        bool unique;
+        bool deduced;
+        double seconds;
+    };
+
+    std::map<std::string, Phase> phases;
+    std::vector<Family> families;
+    std::vector<Probe> probes;
+    std::map<std::string, long long> counters;
+    std::map<std::string, std::string> labels;
+
+public:
+    /**
+     * @brief Adds the time of one execution of a phase
+     */
+    void add_phase(const std::string& name, double seconds);
+
+    /**
+     * @brief Adds the variables and clauses generated by a family of conditions,
+     * accumulated over every formula built
+     */
+    void add_family(const std::string& name, long long n_vars, long long n_clauses, long long n_literals);
+
+    /**
+     * @brief Records a test of the binary search of unique_sol
+     *
+     * @param prefix index of the last constraint switched on
+     * @param unique whether the prefix makes the path unique
+     * @param deduced whether the deduction rules answered without the solver
+     * @param seconds time of the test
+     */
+    void add_probe(int prefix, bool unique, bool deduced, double seconds);
+
+    /**
+     * @brief Adds to a named counter, such as a number of bytes
+     */
+    void add(const std::string& name, long long value);
+
+    /**
+     * @brief Sets a named description of the run, such as its input file
+     */
+    void set_label(const std::string& name, const std::string& value);
+
+    /**
+     * @brief Writes every measure, and the peak resident set size of the process,
+     * as a single line JSON object
+     */
+    void write_json(std::ostream& out) const;
+};
+
+/**
+ * @brief Adds the time between its construction and its destruction to a phase,
+ * if stats are on
+ */
+class PhaseTimer
+{
+private:
+    Stats* stats;
+    const char* name;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    PhaseTimer(Stats* stats, const char* name) : stats(stats), name(name)
+    {
+        if(stats)   start = std::chrono::steady_clock::now();
+    }
+
+    ~PhaseTimer()
+    {
+        if(stats)   stats->add_phase(name, seconds());
+    }
+
+    /**
+     * @return seconds elapsed since the construction
+     */
+    double seconds() const
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+};
+
+#endif //RIKUDOSOLVER_STATS_H
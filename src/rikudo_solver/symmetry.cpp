@@ -0,0 +1,217 @@
+//
+// Created by:
+//    Cauim de S. Lima - cauimsouza@gmail.com
+//    Victor Hugo Vianna Silva - victor.vianna10@gmail.com
+//
+
+#include "symmetry.h"
+#include <algorithm>
+#include <map>
+#include <set>
+
+// the enumeration gives up after this many automorphisms or refinements
+#define max_automorphisms 1024
+#define max_refinements 20000
+
+
+namespace
+{
+    typedef std::vector<int> Colouring;
+
+    struct Enumeration
+    {
+        const std::vector< std::vector<int> >& adj_list;
+        std::vector<Permutation>& found;
+        int n_refinements;
+        bool complete;
+
+        Enumeration(const std::vector< std::vector<int> >& adj_list, std::vector<Permutation>& found)
+            : adj_list(adj_list), found(found), n_refinements(0), complete(true) {}
+    };
+
+    // the colour of a vertex followed by the sorted colours of its neighbors
+    std::vector<int> signature(const std::vector< std::vector<int> >& adj_list, const Colouring& colour, int v)
+    {
+        std::vector<int> s;
+        s.reserve(adj_list[v].size() + 1);
+        for(int w : adj_list[v])
+            s.push_back(colour[w]);
+        std::sort(s.begin(), s.end());
+        s.insert(s.begin(), colour[v]);
+        return s;
+    }
+
+    // refines both sides with the same names for the colours until they are stable,
+    // returns false when a colour stops having as many vertices on both sides
+    bool refine(const std::vector< std::vector<int> >& adj_list, Colouring& left, Colouring& right)
+    {
+        int n = adj_list.size();
+        int n_colours = -1;
+        while(true){
+            std::vector< std::vector<int> > sig_left(n), sig_right(n);
+            std::map< std::vector<int>, int > names;
+            for(int v = 0; v < n; v++){
+                sig_left[v] = signature(adj_list, left, v);
+                sig_right[v] = signature(adj_list, right, v);
+                names[sig_left[v]] = 0;
+                names[sig_right[v]] = 0;
+            }
+            int k = 0;
+            for(auto& name : names)
+                name.second = k++;
+
+            std::vector<int> balance(k, 0);
+            for(int v = 0; v < n; v++){
+                left[v] = names[sig_left[v]];
+                right[v] = names[sig_right[v]];
+                balance[left[v]]++;
+                balance[right[v]]--;
+            }
+            for(int c = 0; c < k; c++)
+                if(balance[c] != 0) return false;
+
+            if(k == n_colours)  return true;
+            n_colours = k;
+        }
+    }
+
+    bool is_automorphism(const std::vector< std::vector<int> >& adj_list, const Permutation& p)
+    {
+        int n = adj_list.size();
+        std::vector<int> image, target;
+        for(int u = 0; u < n; u++){
+            image.clear();
+            for(int v : adj_list[u])
+                image.push_back(p[v]);
+            target = adj_list[p[u]];
+            std::sort(image.begin(), image.end());
+            std::sort(target.begin(), target.end());
+            if(image != target) return false;
+        }
+        return true;
+    }
+
+    void enumerate(Enumeration& e, Colouring left, Colouring right)
+    {
+        if(!e.complete) return;
+        if(++e.n_refinements > max_refinements || (int) e.found.size() >= max_automorphisms){
+            e.complete = false;
+            return;
+        }
+        if(!refine(e.adj_list, left, right))    return;
+
+        int n = e.adj_list.size();
+        std::vector<int> size(n, 0);
+        for(int v = 0; v < n; v++)
+            size[left[v]]++;
+        int cell = -1;
+        for(int c = 0; c < n && cell == -1; c++)
+            if(size[c] > 1) cell = c;
+
+        // every vertex has a colour of its own, the colours give the permutation
+        if(cell == -1){
+            std::vector<int> with_colour(n);
+            for(int v = 0; v < n; v++)
+                with_colour[right[v]] = v;
+            Permutation p(n);
+            bool identity = true;
+            for(int v = 0; v < n; v++){
+                p[v] = with_colour[left[v]];
+                if(p[v] != v)   identity = false;
+            }
+            if(!identity && is_automorphism(e.adj_list, p))
+                e.found.push_back(p);
+            return;
+        }
+
+        // the first vertex of the cell on the left is matched with each one on the right
+        int v = std::find(left.begin(), left.end(), cell) - left.begin();
+        for(int w = 0; w < n && e.complete; w++){
+            if(right[w] != cell)    continue;
+            Colouring l(left), r(right);
+            l[v] = r[w] = n;
+            enumerate(e, l, r);
+        }
+    }
+}
+
+
+Symmetry::Symmetry(const std::vector< std::vector<int> >& adj_list)
+    : n_vertices(adj_list.size()), complete(true)
+{
+    if(n_vertices == 0)   return;
+
+    Enumeration e(adj_list, automorphisms);
+    enumerate(e, Colouring(n_vertices, 0), Colouring(n_vertices, 0));
+    complete = e.complete;
+}
+
+std::vector<Permutation> Symmetry::stabilizer(const std::vector<int>& fixed,
+                                              const std::vector< std::pair<int,int> >& diamonds) const
+{
+    std::set< std::pair<int,int> > pairs;
+    for(auto u_v : diamonds)
+        pairs.insert(std::minmax(u_v.first, u_v.second));
+
+    std::vector<Permutation> kept;
+    for(auto& p : automorphisms){
+        bool ok = true;
+        for(int v : fixed)
+            if(p[v] != v)   ok = false;
+        for(auto u_v : pairs)
+            if(ok && !pairs.count(std::minmax(p[u_v.first], p[u_v.second])))
+                ok = false;
+        if(ok)  kept.push_back(p);
+    }
+    return kept;
+}
+
+std::vector<int> Symmetry::orbits(int n_vertices, const std::vector<Permutation>& perms)
+{
+    // union-find whose roots are the smallest vertices of their sets
+    std::vector<int> parent(n_vertices);
+    for(int v = 0; v < n_vertices; v++)
+        parent[v] = v;
+    auto find = [&parent](int v){
+        while(parent[v] != v){
+            parent[v] = parent[parent[v]];
+            v = parent[v];
+        }
+        return v;
+    };
+
+    for(auto& p : perms)
+        for(int v = 0; v < n_vertices; v++){
+            int a = find(v);
+            int b = find(p[v]);
+            if(a != b)  parent[std::max(a, b)] = std::min(a, b);
+        }
+
+    std::vector<int> smallest(n_vertices);
+    for(int v = 0; v < n_vertices; v++)
+        smallest[v] = find(v);
+    return smallest;
+}
+
+std::vector<Permutation> Symmetry::transversal(int n_vertices, int v, const std::vector<Permutation>& perms)
+{
+    std::vector<Permutation> to(n_vertices);
+    to[v].resize(n_vertices);
+    for(int u = 0; u < n_vertices; u++)
+        to[v][u] = u;
+
+    // breadth first search of the orbit, composing the generators along the way
+    std::vector<int> queue(1, v);
+    for(int i = 0; i < (int) queue.size(); i++){
+        int u = queue[i];
+        for(auto& p : perms){
+            int w = p[u];
+            if(!to[w].empty())  continue;
+            to[w].resize(n_vertices);
+            for(int x = 0; x < n_vertices; x++)
+                to[w][x] = p[to[u][x]];
+            queue.push_back(w);
+        }
+    }
+    return to;
+}
@@ -0,0 +1,90 @@
+//
+// Created by:
+//    Cauim de S. Lima - cauimsouza@gmail.com
+//    Victor Hugo Vianna Silva - victor.vianna10@gmail.com
+//
+
+#ifndef RIKUDOSOLVER_SYMMETRY_H
+#define RIKUDOSOLVER_SYMMETRY_H
+
+#include <utility>
+#include <vector>
+
+/**
+ * Permutation of the vertices of a graph, p[v] being the image of vertex v
+ */
+typedef std::vector<int> Permutation;
+
+/**
+ * @brief Automorphisms of a graph: the permutations of its vertices that map every
+ * edge to an edge, such as the rotations and reflections of a symmetric board
+ * @details They are enumerated by individualisation and refinement: the colours of
+ * the vertices are refined by the colours of their neighbours until they are stable,
+ * then a vertex is given a colour of its own on one side and each vertex of its colour
+ * in turn on the other side. The enumeration gives up after a number of automorphisms
+ * or of refinements, the automorphisms found are then only part of the group.
+ *
+ * A set of automorphisms preserving the constraints of a search (the endpoints, the
+ * map and the diamonds) maps solutions to solutions, and so do their compositions,
+ * which is all the searches rely on: the orbits used are those of the group the set
+ * generates, whether or not the set is the whole group.
+ */
+class Symmetry
+{
+private:
+    int n_vertices;
+
+    /**
+     * automorphisms found, the identity excluded
+     */
+    std::vector<Permutation> automorphisms;
+
+    /**
+     * false if the enumeration gave up
+     */
+    bool complete;
+
+public:
+    /**
+     * @param adj_list adjacence list of the graph, the edges are oriented
+     */
+    explicit Symmetry(const std::vector< std::vector<int> >& adj_list);
+
+    /**
+     * @return automorphisms of the graph other than the identity
+     */
+    const std::vector<Permutation>& get_automorphisms() const { return automorphisms; }
+
+    /**
+     * @return true if every automorphism of the graph was found
+     */
+    bool is_complete() const { return complete; }
+
+    /**
+     * @brief Selects the automorphisms preserving some constraints
+     *
+     * @param fixed vertices that must be mapped to themselves
+     * @param diamonds pairs (u, v) that must be mapped to pairs of the list, in any order
+     * @return automorphisms fixing each of the vertices and preserving the diamonds
+     */
+    std::vector<Permutation> stabilizer(const std::vector<int>& fixed,
+                                        const std::vector< std::pair<int,int> >& diamonds) const;
+
+    /**
+     * @param n_vertices number of vertices permuted
+     * @param perms generators of a group
+     * @return for every vertex, the smallest vertex of its orbit under the group
+     */
+    static std::vector<int> orbits(int n_vertices, const std::vector<Permutation>& perms);
+
+    /**
+     * @param n_vertices number of vertices permuted
+     * @param v vertex
+     * @param perms generators of a group
+     * @return for every vertex u of the orbit of v, an element of the group mapping v
+     * to u, and an empty permutation for the vertices outside the orbit
+     */
+    static std::vector<Permutation> transversal(int n_vertices, int v, const std::vector<Permutation>& perms);
+};
+
+#endif //RIKUDOSOLVER_SYMMETRY_H
@@ -0,0 +1,106 @@
+//
+// Created by:
+//    Cauim de S. Lima - cauimsouza@gmail.com
+//    Victor Hugo Vianna Silva - victor.vianna10@gmail.com
+//
+
+#include "thread_pool.h"
+#include <algorithm>
+
+
+ThreadPool::ThreadPool(int n_threads)
+    : queues(std::max(n_threads, 1)), n_queued(0), n_unfinished(0), next_queue(0), done(false)
+{
+    for(int i = 0; i < (int) queues.size(); i++)
+        threads.emplace_back(&ThreadPool::work, this, i);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        done = true;
+    }
+    task_added.notify_all();
+    for(auto& thread : threads)
+        thread.join();
+}
+
+int ThreadPool::size() const
+{
+    return queues.size();
+}
+
+void ThreadPool::submit(const Task& task)
+{
+    Queue& queue = queues[next_queue++ % queues.size()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(task);
+    }
+    {
+        // counted under the pool mutex so that a worker going to sleep cannot miss it
+        std::lock_guard<std::mutex> lock(mutex);
+        n_queued++;
+        n_unfinished++;
+    }
+    task_added.notify_one();
+}
+
+void ThreadPool::wait()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    all_finished.wait(lock, [this]{ return n_unfinished == 0; });
+    if(error){
+        std::exception_ptr thrown = error;
+        error = nullptr;
+        std::rethrow_exception(thrown);
+    }
+}
+
+// takes a task from the worker's own queue, or steals one from another queue
+bool ThreadPool::take(int worker, Task& task)
+{
+    int n = queues.size();
+    for(int i = 0; i < n; i++){
+        Queue& queue = queues[(worker + i) % n];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if(queue.tasks.empty()) continue;
+        if(i == 0){
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        }
+        else{
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+        n_queued--;
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::work(int worker)
+{
+    while(true){
+        Task task;
+        if(take(worker, task)){
+            // an exception leaving the worker would end the process
+            std::exception_ptr thrown;
+            try{
+                task(worker);
+            }
+            catch(...){
+                thrown = std::current_exception();
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            if(thrown && !error)    error = thrown;
+            if(--n_unfinished == 0) all_finished.notify_all();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        task_added.wait(lock, [this]{ return done || n_queued > 0; });
+        if(done && n_queued == 0)   return;
+    }
+}
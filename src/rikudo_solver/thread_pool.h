@@ -0,0 +1,89 @@
+//
+// Created by:
+//    Cauim de S. Lima - cauimsouza@gmail.com
+//    Victor Hugo Vianna Silva - victor.vianna10@gmail.com
+//
+
+#ifndef RIKUDOSOLVER_THREAD_POOL_H
+#define RIKUDOSOLVER_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fixed set of worker threads sharing tasks by work stealing
+ * @details Every worker owns a queue of tasks. Submitted tasks are spread over the
+ * queues, a worker takes tasks from the back of its own queue and, once it is empty,
+ * steals from the front of the queues of the other workers.
+ */
+class ThreadPool
+{
+public:
+    /**
+     * Function run by a worker, which receives the index of the worker in [0, size())
+     * so that it can use state of its own
+     */
+    typedef std::function<void(int)> Task;
+
+private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<Queue> queues;
+    std::vector<std::thread> threads;
+
+    std::mutex mutex;
+    std::condition_variable task_added;
+    std::condition_variable all_finished;
+
+    std::atomic<int> n_queued;
+    int n_unfinished;
+    std::atomic<unsigned> next_queue;
+    bool done;
+
+    /**
+     * first exception thrown by a task since the last wait
+     */
+    std::exception_ptr error;
+
+    bool take(int worker, Task& task);
+    void work(int worker);
+
+public:
+    /**
+     * @param n_threads number of worker threads, at least 1
+     */
+    explicit ThreadPool(int n_threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @return number of worker threads
+     */
+    int size() const;
+
+    /**
+     * @brief Schedules a task to be run by one of the workers
+     */
+    void submit(const Task& task);
+
+    /**
+     * @brief Blocks until every submitted task has finished
+     * @details A task throwing does not stop its worker: the first exception thrown is
+     * kept and thrown again here once the other tasks are over
+     */
+    void wait();
+};
+
+#endif //RIKUDOSOLVER_THREAD_POOL_H
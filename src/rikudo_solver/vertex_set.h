@@ -0,0 +1,176 @@
+//
+// Created by:
+//    Cauim de S. Lima - cauimsouza@gmail.com
+//    Victor Hugo Vianna Silva - victor.vianna10@gmail.com
+//
+
+#ifndef RIKUDOSOLVER_VERTEX_SET_H
+#define RIKUDOSOLVER_VERTEX_SET_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Set of vertices stored as a bitset of N bits held in fixed size words
+ * @details The words are kept inline, so that sets of small boards stay in registers
+ * and every operation is a loop of known length that the compiler unrolls.
+ * DynamicVertexSet has the same interface for boards with more than 256 vertices.
+ */
+template<int N>
+class FixedVertexSet
+{
+public:
+    static const int n_words = (N + 63) / 64;
+
+    uint64_t words[n_words];
+
+    // the size is fixed by N, it is only taken for the interface of DynamicVertexSet
+    explicit FixedVertexSet(int = N)
+    {
+        clear();
+    }
+
+    void clear()
+    {
+        for(int i = 0; i < n_words; i++)
+            words[i] = 0;
+    }
+
+    void insert(int v)          { words[v >> 6] |= uint64_t(1) << (v & 63); }
+    void erase(int v)           { words[v >> 6] &= ~(uint64_t(1) << (v & 63)); }
+    bool contains(int v) const  { return (words[v >> 6] >> (v & 63)) & 1; }
+
+    bool empty() const
+    {
+        uint64_t any = 0;
+        for(int i = 0; i < n_words; i++)
+            any |= words[i];
+        return any == 0;
+    }
+
+    /**
+     * @return number of vertices in both this set and other
+     */
+    int count_common(const FixedVertexSet& other) const
+    {
+        int count = 0;
+        for(int i = 0; i < n_words; i++)
+            count += __builtin_popcountll(words[i] & other.words[i]);
+        return count;
+    }
+
+    /**
+     * @brief this = (this | a) & b
+     */
+    void unite_within(const FixedVertexSet& a, const FixedVertexSet& b)
+    {
+        for(int i = 0; i < n_words; i++)
+            words[i] = (words[i] | a.words[i]) & b.words[i];
+    }
+
+    /**
+     * @brief this = a & ~b
+     */
+    void assign_difference(const FixedVertexSet& a, const FixedVertexSet& b)
+    {
+        for(int i = 0; i < n_words; i++)
+            words[i] = a.words[i] & ~b.words[i];
+    }
+
+    /**
+     * @brief this = a & b
+     */
+    void assign_intersection(const FixedVertexSet& a, const FixedVertexSet& b)
+    {
+        for(int i = 0; i < n_words; i++)
+            words[i] = a.words[i] & b.words[i];
+    }
+
+    /**
+     * @return true if every vertex of this set is in other
+     */
+    bool subset_of(const FixedVertexSet& other) const
+    {
+        uint64_t outside = 0;
+        for(int i = 0; i < n_words; i++)
+            outside |= words[i] & ~other.words[i];
+        return outside == 0;
+    }
+
+    /**
+     * @brief Calls f(v) for every vertex v of the set, in increasing order
+     */
+    template<class F>
+    void for_each(F f) const
+    {
+        for(int i = 0; i < n_words; i++)
+            for(uint64_t w = words[i]; w; w &= w - 1)
+                f(i * 64 + __builtin_ctzll(w));
+    }
+};
+
+/**
+ * @brief Set of vertices stored as a bitset whose size is only known at run time
+ */
+class DynamicVertexSet
+{
+public:
+    std::vector<uint64_t> words;
+
+    explicit DynamicVertexSet(int n_vertices = 0) : words((n_vertices + 63) / 64, 0) {}
+
+    void clear()                { words.assign(words.size(), 0); }
+    void insert(int v)          { words[v >> 6] |= uint64_t(1) << (v & 63); }
+    void erase(int v)           { words[v >> 6] &= ~(uint64_t(1) << (v & 63)); }
+    bool contains(int v) const  { return (words[v >> 6] >> (v & 63)) & 1; }
+
+    bool empty() const
+    {
+        for(uint64_t w : words)
+            if(w)   return false;
+        return true;
+    }
+
+    int count_common(const DynamicVertexSet& other) const
+    {
+        int count = 0;
+        for(size_t i = 0; i < words.size(); i++)
+            count += __builtin_popcountll(words[i] & other.words[i]);
+        return count;
+    }
+
+    void unite_within(const DynamicVertexSet& a, const DynamicVertexSet& b)
+    {
+        for(size_t i = 0; i < words.size(); i++)
+            words[i] = (words[i] | a.words[i]) & b.words[i];
+    }
+
+    void assign_difference(const DynamicVertexSet& a, const DynamicVertexSet& b)
+    {
+        for(size_t i = 0; i < words.size(); i++)
+            words[i] = a.words[i] & ~b.words[i];
+    }
+
+    void assign_intersection(const DynamicVertexSet& a, const DynamicVertexSet& b)
+    {
+        for(size_t i = 0; i < words.size(); i++)
+            words[i] = a.words[i] & b.words[i];
+    }
+
+    bool subset_of(const DynamicVertexSet& other) const
+    {
+        for(size_t i = 0; i < words.size(); i++)
+            if(words[i] & ~other.words[i])  return false;
+        return true;
+    }
+
+    template<class F>
+    void for_each(F f) const
+    {
+        for(size_t i = 0; i < words.size(); i++)
+            for(uint64_t w = words[i]; w; w &= w - 1)
+                f(i * 64 + __builtin_ctzll(w));
+    }
+};
+
+#endif //RIKUDOSOLVER_VERTEX_SET_H